@@ -32,7 +32,11 @@ namespace coyote
                 
     void AccessDirector::handle(std::shared_ptr<coyote::CacheRequest> r)
     {
-        if(r->memoryAck() && !r->getBypassL2())
+        if(r->getCoherenceCommand()!=CacheRequest::CoherenceCommand::NONE)
+        {
+            handleCoherence_(r);
+        }
+        else if(r->memoryAck() && !r->getBypassL2())
         {
             r->setMemoryAck(false);
             r->setServiced();
@@ -40,14 +44,7 @@ namespace coyote
         }
         else if(!r->isServiced())
         {
-            uint64_t address=r->getAddress();
-            uint64_t memory_controller=0;
-            if(mc_mask!=0)
-            {
-                memory_controller=(address >> mc_shift) & mc_mask;
-            }
-            
-            r->setMemoryController(memory_controller);
+            r->setMemoryController(calculateMemoryController_(r->getAddress()));
            
             if(!r->getBypassL2())
             {
@@ -96,6 +93,7 @@ namespace coyote
         }
         else
         {
+            notifyServiced_(r);
             if(r->getType()==CacheRequest::AccessType::STORE || r->getType()==CacheRequest::AccessType::WRITEBACK)
             {
                 if(tile->trace_)
@@ -357,7 +355,8 @@ namespace coyote
 
     std::shared_ptr<NoCMessage> AccessDirector::getRemoteL2RequestMessage(std::shared_ptr<CacheRequest> req)
     {
-        return std::make_shared<NoCMessage>(req, NoCMessageType::REMOTE_L2_REQUEST, address_size, req->getSourceTile(), req->getHomeTile());
+        //The request may be forwarded by a tile other than the source
+        return std::make_shared<NoCMessage>(req, NoCMessageType::REMOTE_L2_REQUEST, address_size, tile->id_, req->getHomeTile());
     }
             
     std::shared_ptr<NoCMessage> AccessDirector::getMemoryRequestMessage(std::shared_ptr<CacheRequest> req)
@@ -374,22 +373,19 @@ namespace coyote
         }
         else if(req->getType()==CacheRequest::AccessType::WRITEBACK)
         {
-            uint64_t address=req->getAddress();
-            
-            uint64_t memory_controller=0;
-            if(mc_mask!=0)
-            {
-                memory_controller=(address >> mc_shift) & mc_mask;
-            }
-
-            req->setMemoryController(memory_controller);
+            req->setMemoryController(calculateMemoryController_(req->getAddress()));
             //Adds missing info to WRITEBACKS that was not available in the CacheBank 
             size=line_size;
+            //Writebacks leave from the bank that evicts the line
             req->setSourceTile(tile->id_);
-            uint16_t home=calculateHome(req);
-            req->setHomeTile(home);
+            req->setHomeTile(tile->id_);
             type=NoCMessageType::MEMORY_REQUEST_WB;
         }
+        else if(req->isPrefetch())
+        {
+            //Prefetches are generated by the CacheBank for addresses that have not gone through the director
+            req->setMemoryController(calculateMemoryController_(req->getAddress()));
+        }
 
         return std::make_shared<NoCMessage>(req, type, size, req->getHomeTile(), req->getMemoryController());
     }
@@ -404,6 +400,214 @@ namespace coyote
         return std::make_shared<NoCMessage>(req, NoCMessageType::SCRATCHPAD_ACK, 15, tile->id_, req->getSourceTile());
     }
 
+    void AccessDirector::enableCoherence(uint16_t max_pointers, uint32_t max_entries)
+    {
+        directory_=std::make_unique<CoherenceDirectory>(tile->num_tiles_, max_pointers, max_entries);
+    }
+
+    void AccessDirector::notifyCoherence(std::shared_ptr<CacheRequest> req)
+    {
+        CacheRequest::CoherenceCommand command=req->getCoherenceCommand();
+        if(command==CacheRequest::CoherenceCommand::NONE)
+        {
+            switch(req->getType())
+            {
+                case CacheRequest::AccessType::STORE:
+                    command=CacheRequest::CoherenceCommand::GET_MODIFIED;
+                    break;
+                case CacheRequest::AccessType::WRITEBACK:
+                    command=CacheRequest::CoherenceCommand::PUT_MODIFIED;
+                    break;
+                default:
+                    command=CacheRequest::CoherenceCommand::GET_SHARED;
+            }
+        }
+
+        uint64_t line=(req->getAddress() >> block_offset_bits) << block_offset_bits;
+        if(req->getCoherenceCommand()==CacheRequest::CoherenceCommand::NONE && command!=CacheRequest::CoherenceCommand::PUT_MODIFIED)
+        {
+            //The miss accesses memory once the directory grants it
+            waiting_for_grant_.emplace(line, std::make_pair(req, tile->getClock()->currentCycle()));
+        }
+
+        std::shared_ptr<CacheRequest> c=std::make_shared<CacheRequest>(line, req->getType(), req->getPC(), tile->getClock()->currentCycle(), req->getCoreId());
+        c->setCoherenceCommand(command);
+        c->setSourceTile(tile->id_);
+        c->setHomeTile(calculateDirectoryHome_(line));
+        if(c->getHomeTile()==tile->id_)
+        {
+            handleCoherence_(c);
+        }
+        else
+        {
+            sendCoherenceMessage_(c, NoCMessageType::COHERENCE_REQUEST, c->getHomeTile(), false, req->getCacheBank());
+        }
+    }
+
+    uint16_t AccessDirector::calculateDirectoryHome_(uint64_t address)
+    {
+        return (address >> block_offset_bits) % tile->num_tiles_;
+    }
+
+    uint64_t AccessDirector::calculateMemoryController_(uint64_t address)
+    {
+        if(mc_mask==0)
+        {
+            return 0;
+        }
+        return (address >> mc_shift) & mc_mask;
+    }
+
+    void AccessDirector::handleCoherence_(std::shared_ptr<coyote::CacheRequest> r)
+    {
+        switch(r->getCoherenceCommand())
+        {
+            case CacheRequest::CoherenceCommand::GET_SHARED:
+            case CacheRequest::CoherenceCommand::GET_MODIFIED:
+            case CacheRequest::CoherenceCommand::PUT_MODIFIED:
+            {
+                sparta_assert(directory_!=nullptr, "Got a coherence request with coherence disabled");
+                tile->count_directory_requests_++;
+                coherence_actions_.clear();
+                if(directory_->access(r->getAddress(), r->getSourceTile(), r->getCoherenceCommand(), coherence_actions_))
+                {
+                    tile->count_directory_broadcasts_++;
+                }
+
+                //The request is granted once the commands on its line are acknowledged. Recalls do not delay it
+                uint32_t acks=0;
+                for(const CoherenceDirectory::Action& a : coherence_actions_)
+                {
+                    if(a.line==r->getAddress())
+                    {
+                        acks++;
+                    }
+                }
+                bool granted=r->getCoherenceCommand()==CacheRequest::CoherenceCommand::PUT_MODIFIED || acks==0;
+                if(!granted)
+                {
+                    //Set before sending the commands, as those to this tile are acknowledged immediately
+                    pending_coherence_acks_[std::make_pair(r->getAddress(), r->getSourceTile())]+=acks;
+                }
+
+                for(const CoherenceDirectory::Action& a : coherence_actions_)
+                {
+                    std::shared_ptr<CacheRequest> c=std::make_shared<CacheRequest>(a.line, CacheRequest::AccessType::LOAD, r->getPC(), tile->getClock()->currentCycle(), r->getCoreId());
+                    c->setCoherenceCommand(a.command);
+                    c->setSourceTile(r->getSourceTile());
+                    c->setHomeTile(tile->id_);
+
+                    NoCMessageType type=NoCMessageType::COHERENCE_INVALIDATE;
+                    if(a.line!=r->getAddress())
+                    {
+                        tile->count_directory_recall_invalidations_++;
+                    }
+                    else if(a.command==CacheRequest::CoherenceCommand::INVALIDATE)
+                    {
+                        tile->count_directory_invalidations_++;
+                    }
+                    else
+                    {
+                        tile->count_directory_forwards_++;
+                        type=NoCMessageType::COHERENCE_FORWARD;
+                    }
+
+                    if(a.tile==tile->id_)
+                    {
+                        handleCoherence_(c);
+                    }
+                    else
+                    {
+                        sendCoherenceMessage_(c, type, a.tile, true, c->getCoreId());
+                    }
+                }
+
+                if(granted && r->getCoherenceCommand()!=CacheRequest::CoherenceCommand::PUT_MODIFIED)
+                {
+                    sendCoherenceGrant_(r);
+                }
+                break;
+            }
+
+            case CacheRequest::CoherenceCommand::INVALIDATE:
+            case CacheRequest::CoherenceCommand::FORWARD:
+            {
+                //The command is applied by the bank that holds the line in the private L2 of this tile
+                r->setCacheBank(calculateBank(r));
+                tile->issueLocalRequest_(r, 0);
+
+                std::shared_ptr<CacheRequest> ack=std::make_shared<CacheRequest>(r->getAddress(), CacheRequest::AccessType::LOAD, r->getPC(), tile->getClock()->currentCycle(), r->getCoreId());
+                ack->setCoherenceCommand(CacheRequest::CoherenceCommand::ACK);
+                ack->setSourceTile(r->getSourceTile());
+                ack->setHomeTile(r->getHomeTile());
+                if(r->getHomeTile()==tile->id_)
+                {
+                    handleCoherence_(ack);
+                }
+                else
+                {
+                    sendCoherenceMessage_(ack, NoCMessageType::COHERENCE_ACK, r->getHomeTile(), true, ack->getCoreId());
+                }
+                break;
+            }
+
+            case CacheRequest::CoherenceCommand::ACK:
+            {
+                tile->count_coherence_acks_++;
+                //The acks of recalls and of the invalidations of D-NUCA replicas are not waited for
+                auto pending=pending_coherence_acks_.find(std::make_pair(r->getAddress(), r->getSourceTile()));
+                if(pending!=pending_coherence_acks_.end() && --pending->second==0)
+                {
+                    pending_coherence_acks_.erase(pending);
+                    sendCoherenceGrant_(r);
+                }
+                break;
+            }
+
+            case CacheRequest::CoherenceCommand::GRANT:
+            {
+                //Upgrades of lines that are present do not wait for their grant
+                auto waiting=waiting_for_grant_.find(r->getAddress());
+                if(waiting!=waiting_for_grant_.end())
+                {
+                    tile->count_coherence_wait_cycles_+=tile->getClock()->currentCycle()-waiting->second.second;
+                    tile->issueMemoryControllerRequest_(waiting->second.first, false);
+                    waiting_for_grant_.erase(waiting);
+                }
+                break;
+            }
+
+            default:
+                sparta_assert(false, "Unexpected coherence command");
+        }
+    }
+
+    void AccessDirector::sendCoherenceGrant_(std::shared_ptr<coyote::CacheRequest> r)
+    {
+        std::shared_ptr<CacheRequest> grant=std::make_shared<CacheRequest>(r->getAddress(), CacheRequest::AccessType::LOAD, r->getPC(), tile->getClock()->currentCycle(), r->getCoreId());
+        grant->setCoherenceCommand(CacheRequest::CoherenceCommand::GRANT);
+        grant->setSourceTile(r->getSourceTile());
+        grant->setHomeTile(tile->id_);
+        if(r->getSourceTile()==tile->id_)
+        {
+            handleCoherence_(grant);
+        }
+        else
+        {
+            sendCoherenceMessage_(grant, NoCMessageType::COHERENCE_ACK, r->getSourceTile(), true, grant->getCoreId());
+        }
+    }
+
+    void AccessDirector::sendCoherenceMessage_(std::shared_ptr<coyote::CacheRequest> r, NoCMessageType type, uint16_t dst, bool is_core, uint16_t id)
+    {
+        std::shared_ptr<ArbiterMessage> msg = std::make_shared<ArbiterMessage>();
+        msg->msg = std::make_shared<NoCMessage>(r, type, address_size, tile->id_, dst);
+        msg->is_core = is_core;
+        msg->id = id;
+        msg->type = coyote::MessageType::NOC_MSG;
+        tile->out_port_arbiter_.send(msg, 0);
+    }
+
     uint16_t AccessDirector::calculateBank(std::shared_ptr<coyote::ScratchpadRequest> r)
     {
         uint16_t destination=0;
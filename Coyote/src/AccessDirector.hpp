@@ -25,8 +25,12 @@
 #include "CacheDataMappingPolicy.hpp"
 #include "VRegMappingPolicy.hpp"
 #include "EventVisitor.hpp"
+#include "CoherenceDirectory.hpp"
+#include "NoC/NoCMessageType.hpp"
 
 #include <map>
+#include <memory>
+#include <unordered_map>
 
 namespace coyote
 {
@@ -122,7 +126,24 @@ namespace coyote
 
             uint16_t getCoresPerTile();
 
+            /*!
+             * \brief Keep the private L2s of the tiles coherent with a directory distributed among the tiles
+             * \param max_pointers The number of sharers tracked by each directory entry. 0 tracks all the tiles
+             * \param max_entries The number of entries of the directory slice of the tile
+             */
+            void enableCoherence(uint16_t max_pointers, uint32_t max_entries);
+
+            /*!
+             * \brief Notify the directory of a request that leaves a bank of the tile
+             * \param req The request. Misses on loads, fetches and prefetches get a shared copy, stores and upgrades
+             * (requests that carry GET_MODIFIED) get the exclusive permission and writebacks release the ownership
+             * \note The request itself is not modified. The directory is sent a new request for the line
+             */
+            void notifyCoherence(std::shared_ptr<CacheRequest> req);
+
         protected:
+            Tile * tile;
+
             uint64_t line_size;
 
             uint8_t tag_bits;
@@ -133,8 +154,6 @@ namespace coyote
             
 
         private:
-            Tile * tile;
-
             uint64_t num_ways;
             uint16_t num_banks_per_core;
             uint64_t way_size;
@@ -155,6 +174,11 @@ namespace coyote
 
             uint16_t cores_per_tile=0;
 
+            std::unique_ptr<CoherenceDirectory> directory_;                //! nullptr if coherence is disabled
+            std::vector<CoherenceDirectory::Action> coherence_actions_;
+            std::map<std::pair<uint64_t, uint16_t>, uint32_t> pending_coherence_acks_;  //! Acks missing before a request is granted, by line and requester
+            std::unordered_multimap<uint64_t, std::pair<std::shared_ptr<CacheRequest>, uint64_t>> waiting_for_grant_; //! Misses of the tile and the cycle they started waiting, by line
+
             /*!              
             * \brief Calculate the home tile and bank for a request
             * \param r A Request
@@ -184,8 +208,51 @@ namespace coyote
             * \return The bank to access
             */
             uint16_t calculateBank(std::shared_ptr<coyote::ScratchpadRequest> r);
-            
+
+            /*!
+            * \brief Calculate the tile that holds the directory entry of an address. Lines are interleaved among the tiles
+            * \param address The address
+            * \return The tile
+            */
+            uint16_t calculateDirectoryHome_(uint64_t address);
+
+            /*!
+            * \brief Calculate the memory controller that handles an address. There is one channel per memory controller
+            * \param address The address
+            * \return The memory controller
+            */
+            uint64_t calculateMemoryController_(uint64_t address);
+
         protected:
+            /*!
+            * \brief Handle a coherence message, either a request to the directory slice of the tile, a command
+            * for the private L2 of the tile, the acknowledgement of a command or the grant of a miss of the tile
+            * \param r The message
+            */
+            void handleCoherence_(std::shared_ptr<coyote::CacheRequest> r);
+
+            /*!
+            * \brief Send a coherence message to another tile
+            * \param r The message
+            * \param type The type of the NoC message
+            * \param dst The destination tile
+            * \param is_core Whether the message enters the arbiter through the queue of a core or of a bank
+            * \param id The core or bank
+            */
+            void sendCoherenceMessage_(std::shared_ptr<coyote::CacheRequest> r, NoCMessageType type, uint16_t dst, bool is_core, uint16_t id);
+
+            /*!
+            * \brief Tell the requester of a GET_SHARED or GET_MODIFIED that its invalidations and forward have been acknowledged
+            * \param r The request or the last of its acknowledgements
+            */
+            void sendCoherenceGrant_(std::shared_ptr<coyote::CacheRequest> r);
+
+            /*!
+            * \brief Notify a serviced request before it is acknowledged, either in the tile that serviced it or in the requesting tile
+            * \param r The request
+            */
+            virtual void notifyServiced_(std::shared_ptr<coyote::CacheRequest>){}
+            
             CacheDataMappingPolicy bank_data_mapping_policy_;
             VRegMappingPolicy scratchpad_data_mapping_policy_;
 
@@ -0,0 +1,245 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "sparta/utils/SpartaAssert.hpp"
+#include "AccessProfiler.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace coyote
+{
+    AccessProfiler::AccessProfiler(uint32_t sampling, uint64_t interval, uint64_t line_size, const std::string& prefix) :
+        sampling_(sampling),
+        interval_(interval),
+        line_size_(line_size),
+        prefix_(prefix),
+        tree_(INITIAL_CAPACITY+1, 0),
+        next_slot_(0),
+        last_slot_(),
+        all_(),
+        pages_(),
+        pcs_(),
+        interval_end_(interval),
+        interval_accesses_(0),
+        interval_lines_(),
+        interval_pages_(),
+        working_set_file_()
+    {
+        sparta_assert(sampling>0, "The sampling of the access profiler must be at least 1");
+        if(interval_>0)
+        {
+            working_set_file_.open(prefix_+"working_set.csv");
+            sparta_assert(working_set_file_.is_open(), "Could not open the working set file " << prefix_ << "working_set.csv");
+            working_set_file_ << "cycle;accesses;lines;bytes;pages" << std::endl;
+        }
+    }
+
+    AccessProfiler::~AccessProfiler()
+    {
+        if(working_set_file_.is_open())
+        {
+            writeInterval_(interval_end_);
+            working_set_file_.close();
+        }
+        std::ofstream stream(prefix_+"reuse_distance.csv");
+        writeHeader_(stream, "stream");
+        writeHistogram_(stream, "all", all_);
+        writeHistograms_(prefix_+"pages.csv", "page", pages_);
+        writeHistograms_(prefix_+"pcs.csv", "pc", pcs_);
+    }
+
+    void AccessProfiler::access(uint64_t address, uint64_t pc, uint64_t cycle)
+    {
+        uint64_t line=address/line_size_;
+        uint64_t page=address/PAGE_SIZE;
+
+        if(interval_>0)
+        {
+            //The intervals without accesses are written as empty rows
+            while(cycle>=interval_end_)
+            {
+                writeInterval_(interval_end_);
+                interval_end_+=interval_;
+            }
+            interval_accesses_++;
+            if(isSampled_(line))
+            {
+                interval_lines_.insert(line);
+            }
+            if(isSampled_(page))
+            {
+                interval_pages_.insert(page);
+            }
+        }
+
+        if(!isSampled_(line))
+        {
+            return;
+        }
+
+        uint64_t distance=reuseDistance_(line);
+        if(distance!=COLD)
+        {
+            distance*=sampling_;
+        }
+        record_(all_, distance);
+        record_(pages_[page*PAGE_SIZE], distance);
+        record_(pcs_[pc], distance);
+    }
+
+    bool AccessProfiler::isSampled_(uint64_t id) const
+    {
+        //Finalizer of MurmurHash3, so that strided streams are sampled uniformly
+        id^=id >> 33;
+        id*=0xff51afd7ed558ccdULL;
+        id^=id >> 33;
+        return id%sampling_==0;
+    }
+
+    uint64_t AccessProfiler::reuseDistance_(uint64_t line)
+    {
+        if(next_slot_==tree_.size()-1)
+        {
+            compact_();
+        }
+
+        uint64_t distance=COLD;
+        uint64_t slot=next_slot_++;
+        auto it=last_slot_.find(line);
+        if(it!=last_slot_.end())
+        {
+            //Every line accessed after the previous access to this one has its last access in a later slot
+            distance=prefixSum_(slot)-prefixSum_(it->second+1);
+            addToTree_(it->second, -1);
+            it->second=slot;
+        }
+        else
+        {
+            last_slot_.emplace(line, slot);
+        }
+        addToTree_(slot, 1);
+        return distance;
+    }
+
+    void AccessProfiler::addToTree_(uint64_t slot, int32_t value)
+    {
+        for(uint64_t i=slot+1; i<tree_.size(); i+=i & (~i+1))
+        {
+            tree_[i]+=value;
+        }
+    }
+
+    uint64_t AccessProfiler::prefixSum_(uint64_t slot) const
+    {
+        //Number of marked slots before slot
+        uint64_t sum=0;
+        for(uint64_t i=slot; i>0; i-=i & (~i+1))
+        {
+            sum+=tree_[i];
+        }
+        return sum;
+    }
+
+    void AccessProfiler::compact_()
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> slots;
+        slots.reserve(last_slot_.size());
+        for(const auto& l : last_slot_)
+        {
+            slots.emplace_back(l.second, l.first);
+        }
+        std::sort(slots.begin(), slots.end());
+
+        uint64_t capacity=tree_.size()-1;
+        if(slots.size()>capacity/2)
+        {
+            capacity*=2;
+        }
+        tree_.assign(capacity+1, 0);
+        for(uint64_t i=0; i<slots.size(); i++)
+        {
+            last_slot_[slots[i].second]=i;
+            addToTree_(i, 1);
+        }
+        next_slot_=slots.size();
+    }
+
+    void AccessProfiler::record_(Histogram& h, uint64_t distance)
+    {
+        h.accesses++;
+        if(distance==COLD)
+        {
+            h.cold++;
+            return;
+        }
+        uint8_t bucket=(distance==0) ? 0 : 64-__builtin_clzll(distance);
+        h.buckets[std::min<uint8_t>(bucket, NUM_BUCKETS-1)]++;
+    }
+
+    void AccessProfiler::writeInterval_(uint64_t cycle)
+    {
+        working_set_file_ << cycle << ";" << interval_accesses_ << ";" << interval_lines_.size()*sampling_ << ";"
+                          << interval_lines_.size()*sampling_*line_size_ << ";" << interval_pages_.size()*sampling_ << "\n";
+        interval_accesses_=0;
+        interval_lines_.clear();
+        interval_pages_.clear();
+    }
+
+    void AccessProfiler::writeHistograms_(const std::string& file, const std::string& key_name, const std::unordered_map<uint64_t, Histogram>& histograms) const
+    {
+        std::ofstream str(file);
+        writeHeader_(str, key_name);
+
+        //Sorted by key, so the files of two runs can be compared
+        std::vector<uint64_t> keys;
+        keys.reserve(histograms.size());
+        for(const auto& h : histograms)
+        {
+            keys.push_back(h.first);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        for(uint64_t k : keys)
+        {
+            std::ostringstream key;
+            key << "0x" << std::hex << k;
+            writeHistogram_(str, key.str(), histograms.at(k));
+        }
+    }
+
+    void AccessProfiler::writeHeader_(std::ostream& str, const std::string& key_name) const
+    {
+        str << key_name << ";accesses;cold;0;1";
+        for(uint8_t b=2; b<NUM_BUCKETS-1; b++)
+        {
+            str << ";" << (uint64_t(1) << (b-1)) << "-" << (uint64_t(1) << b)-1;
+        }
+        str << ";>=" << (uint64_t(1) << (NUM_BUCKETS-2)) << "\n";
+    }
+
+    void AccessProfiler::writeHistogram_(std::ostream& str, const std::string& key, const Histogram& h) const
+    {
+        str << key << ";" << h.accesses << ";" << h.cold;
+        for(uint64_t b : h.buckets)
+        {
+            str << ";" << b;
+        }
+        str << "\n";
+    }
+}
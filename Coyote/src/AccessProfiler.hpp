@@ -0,0 +1,145 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __ACCESS_PROFILER_HH__
+#define __ACCESS_PROFILER_HH__
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace coyote
+{
+    class AccessProfiler
+    {
+        /*!
+         * \class coyote::AccessProfiler
+         * \brief Profiles the reuse distance and the working set of the accesses that reach the L2, independently of the caches.
+         *
+         * The reuse distance of an access is the number of different lines accessed since the previous access to its line.
+         * It is computed with a Fenwick tree that marks the last access to each line (Olken's algorithm). Only the lines
+         * selected by a hash of their address are profiled (one out of every sampling lines), and their distances are scaled
+         * by the sampling, so the profile of the sampled lines represents the whole stream.
+         *
+         * Distances are accumulated in power-of-two histograms for the whole stream, for each 4KB page and for each PC.
+         * The working set of each interval of cycles is estimated from the lines and pages it samples.
+         */
+        public:
+
+            /*!
+            * \brief Constructor for AccessProfiler
+            * \param sampling One out of every sampling lines (and pages for the working set) is profiled
+            * \param interval The number of cycles of each interval of the working set (0 disables it)
+            * \param line_size The size of a line in bytes
+            * \param prefix The prefix of the CSV files where the profile is written
+            */
+            AccessProfiler(uint32_t sampling, uint64_t interval, uint64_t line_size, const std::string& prefix);
+
+            /*!
+            * \brief Destructor for AccessProfiler. Writes the histograms and the last interval of the working set
+            */
+            ~AccessProfiler();
+
+            /*!
+            * \brief Record an access
+            * \param address The accessed address
+            * \param pc The PC of the instruction that made the access
+            * \param cycle The cycle of the access
+            */
+            void access(uint64_t address, uint64_t pc, uint64_t cycle);
+
+        private:
+            static constexpr uint64_t PAGE_SIZE=4096;
+            static constexpr uint8_t NUM_BUCKETS=24;        //! Distance 0, one bucket for each [2^(b-1), 2^b) and one for the larger ones
+            static constexpr uint64_t INITIAL_CAPACITY=1 << 16;
+            static constexpr uint64_t COLD=UINT64_MAX;
+
+            struct Histogram
+            {
+                uint64_t accesses=0;
+                uint64_t cold=0;                            //! First accesses to a line
+                std::array<uint64_t, NUM_BUCKETS> buckets{};
+            };
+
+            uint32_t sampling_;
+            uint64_t interval_;
+            uint64_t line_size_;
+            std::string prefix_;
+
+            std::vector<uint32_t> tree_;                    //! Fenwick tree over the time slots of the sampled accesses
+            uint64_t next_slot_;
+            std::unordered_map<uint64_t, uint64_t> last_slot_;  //! The slot of the last access to each sampled line
+
+            Histogram all_;
+            std::unordered_map<uint64_t, Histogram> pages_;
+            std::unordered_map<uint64_t, Histogram> pcs_;
+
+            uint64_t interval_end_;
+            uint64_t interval_accesses_;
+            std::unordered_set<uint64_t> interval_lines_;
+            std::unordered_set<uint64_t> interval_pages_;
+            std::ofstream working_set_file_;
+
+            /*!
+            * \brief Whether a line or page is sampled
+            * \param id The line or page
+            * \return True if it is profiled
+            */
+            bool isSampled_(uint64_t id) const;
+
+            /*!
+            * \brief Get the reuse distance of an access to a sampled line and mark it as the last access to the line
+            * \param line The line
+            * \return The number of different sampled lines accessed since the previous access to the line, or COLD
+            */
+            uint64_t reuseDistance_(uint64_t line);
+
+            void addToTree_(uint64_t slot, int32_t value);
+            uint64_t prefixSum_(uint64_t slot) const;
+
+            /*!
+            * \brief Renumber the slots of the last accesses from 0, growing the tree if more than half of it is in use
+            */
+            void compact_();
+
+            void record_(Histogram& h, uint64_t distance);
+
+            /*!
+            * \brief Write the working set of the current interval and start the next one
+            * \param cycle The cycle that ends the interval
+            */
+            void writeInterval_(uint64_t cycle);
+
+            /*!
+            * \brief Write a CSV with a histogram per line
+            * \param file The name of the file
+            * \param key_name The name of the column that identifies each histogram
+            * \param histograms The histograms, written in increasing order of their key
+            */
+            void writeHistograms_(const std::string& file, const std::string& key_name, const std::unordered_map<uint64_t, Histogram>& histograms) const;
+
+            void writeHeader_(std::ostream& str, const std::string& key_name) const;
+            void writeHistogram_(std::ostream& str, const std::string& key, const Histogram& h) const;
+    };
+}
+#endif
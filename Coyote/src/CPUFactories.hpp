@@ -28,6 +28,7 @@
 #include "L3CacheBank.hpp"
 #include "NoC/FunctionalNoC.hpp"
 #include "NoC/SimpleNoC.hpp"
+#include "NoC/AnalyticalNoC.hpp"
 #include "NoC/DetailedNoC.hpp"
 #include "MemoryTile/MemoryCPUWrapper.hpp"
 #include "MemoryTile/MemoryController.hpp"
@@ -53,6 +54,10 @@ struct CPUFactories{
     sparta::ResourceFactory<coyote::SimpleNoC,
                             coyote::SimpleNoC::SimpleNoCParameterSet> simple_noc_rf;
 
+    //! \brief Resource Factory to build an analytical NoC Unit
+    sparta::ResourceFactory<coyote::AnalyticalNoC,
+                            coyote::AnalyticalNoC::AnalyticalNoCParameterSet> analytical_noc_rf;
+
     //! \brief Resource Factory to build a detailed NoC Unit
     sparta::ResourceFactory<coyote::DetailedNoC,
                             coyote::DetailedNoC::DetailedNoCParameterSet> detailed_noc_rf;
@@ -297,10 +297,12 @@ auto coyote::CPUFactory::buildTreeShared_(sparta::RootTreeNode* root_node,
                 noc_rf = &topology_->factories->functional_noc_rf;
             else if(noc_model == "simple")
                 noc_rf = &topology_->factories->simple_noc_rf;
+            else if(noc_model == "analytical")
+                noc_rf = &topology_->factories->analytical_noc_rf;
             else if(noc_model == "detailed")
                 noc_rf = &topology_->factories->detailed_noc_rf;
             else
-                sparta_assert(false, "top.arch.noc.params.noc_model must be: functional, simple or detailed. Not: " << noc_model);
+                sparta_assert(false, "top.arch.noc.params.noc_model must be: functional, simple, analytical or detailed. Not: " << noc_model);
             og_name=unit.name;
             parent_name = unit.parent_name;
             node_name = unit.name;
@@ -560,6 +562,7 @@ auto coyote::CPUFactory::bindTree_(sparta::RootTreeNode* root_node,
                 sparta_assert(l2_node != nullptr);
                 L2CacheBank* bank  = l2_node->getResourceAs<coyote::L2CacheBank>();
                 bank->setTile(tile);
+                bank->setCoherent(tile->isCoherent());
                 arbiter->addBank(bank);
             }
 
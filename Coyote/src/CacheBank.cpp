@@ -21,7 +21,11 @@
 #include "sparta/utils/SpartaAssert.hpp"
 #include "CacheBank.hpp"
 #include "L3CacheBank.hpp"
+#include "NextLinePrefetcher.hpp"
+#include "StridePrefetcher.hpp"
+#include "StreamPrefetcher.hpp"
 #include <chrono>
+#include <algorithm>
 
 namespace coyote
 {
@@ -29,46 +33,212 @@ namespace coyote
     // Constructor
     ////////////////////////////////////////////////////////////////////////////////
 
-    CacheBank::CacheBank(sparta::TreeNode *node, bool always_hit, bool writeback, uint16_t miss_latency, uint16_t hit_latency,
-                         uint16_t max_outstanding_misses, uint16_t max_in_flight_wbs, bool busy, bool unit_test, uint64_t line_size, uint64_t size_kb,
-                         uint64_t associativity, uint64_t lvrf_ways, uint32_t bank_and_tile_offset) :
+    CacheBank::CacheBank(sparta::TreeNode *node, const Config& config) :
         sparta::Unit(node),
         memory_access_allocator(2000, 1000),
-        always_hit_(always_hit),
-        writeback_(writeback),
-        miss_latency_(miss_latency),
-        hit_latency_(hit_latency),
-        max_outstanding_misses_(max_outstanding_misses),
-        busy_(busy),
-        in_flight_misses_(max_outstanding_misses, line_size),
-        max_in_flight_wbs(max_in_flight_wbs),
+        always_hit_(config.always_hit),
+        writeback_(config.writeback),
+        miss_latency_(config.miss_latency),
+        hit_latency_(config.hit_latency),
+        max_outstanding_misses_(config.max_outstanding_misses),
+        tag_latency_(config.tag_latency),
+        serial_access_(config.access_mode=="serial"),
+        initiation_interval_(config.initiation_interval),
+        pipelined_(config.initiation_interval>0),
+        next_issue_cycle_(0),
+        pipeline_busy_until_(0),
+        busy_(false),
+        in_flight_misses_(config.max_outstanding_misses, config.line_size),
+        max_in_flight_wbs(config.max_in_flight_wbs),
         num_in_flight_wbs(0),
         pending_wb(nullptr),
-        pending_fetch_requests_(),
-        pending_load_requests_(),
-        pending_store_requests_(),
-        pending_scratchpad_requests_(),
-        l2_size_kb_(size_kb),
-        l2_associativity_(associativity),
-        l2_line_size_(line_size),
-        bank_and_tile_offset_(bank_and_tile_offset),
+        pending_requests_(),
+        write_combining_buffer_(config.writeback ? 0 : config.write_combining_entries, config.line_size),
+        write_combining_window_(config.write_combining_window),
+        way_partitioner_(config.way_partitioning, config.way_partition_masks, config.associativity),
+        partition_lines_(),
+        way_partition_schedule_(),
+        next_way_partition_change_(0),
+        enabled_ways_(config.associativity-config.lvrf_ways),
+        stack_distance_profiler_(nullptr),
+        stack_distance_file_(config.stack_distance_file_prefix+node->getLocation()+".csv"),
+        l2_size_kb_(config.size_kb),
+        l2_associativity_(config.associativity),
+        l2_line_size_(config.line_size),
+        bank_and_tile_offset_(config.bank_and_tile_offset),
+        vector_fill_policy_(VectorFillPolicy::NORMAL),
+        vector_way_quota_(config.vector_way_quota),
+        vector_reuse_counter_(VECTOR_REUSE_COUNTER_MAX/2+1),
+        prefetcher_(nullptr),
+        prefetch_candidates_(),
+        last_lookup_prefetch_hit_(false),
+        pollution_filter_(),
+        coherent_(false),
+        coherence_filter_(),
+        pending_coherence_(),
         eviction_times_(),
-        unit_test(unit_test)
+        unit_test(config.unit_test)
     {
 
         // Cache config
-        std::unique_ptr<sparta::cache::ReplacementIF> repl(new sparta::cache::TreePLRUReplacement
-                                                         (l2_associativity_));
+        std::unique_ptr<sparta::cache::ReplacementIF> repl;
+        if(config.replacement_policy=="tree_plru")
+        {
+            repl.reset(new sparta::cache::TreePLRUReplacement(l2_associativity_));
+        }
+        else if(config.replacement_policy=="srrip")
+        {
+            repl.reset(new sparta::cache::SRRIPReplacement(l2_associativity_));
+        }
+        else if(config.replacement_policy=="brrip")
+        {
+            repl.reset(new sparta::cache::BRRIPReplacement(l2_associativity_));
+        }
+        else if(config.replacement_policy=="drrip")
+        {
+            repl.reset(new sparta::cache::DRRIPReplacement(l2_associativity_));
+        }
+        else if(config.replacement_policy=="ship")
+        {
+            repl.reset(new sparta::cache::SHiPReplacement(l2_associativity_));
+        }
+        sparta_assert(repl!=nullptr, "The replacement_policy of the cache banks must be tree_plru, srrip, brrip, drrip or ship");
         l2_cache_.reset(new SimpleDL2( getContainer(), l2_size_kb_, l2_line_size_, l2_line_size_*bank_and_tile_offset_, *repl ));
 
         if(SPARTA_EXPECT_FALSE(info_logger_.observed())) {
             info_logger_ << "CacheBank construct: #" << node->getGroupIdx();
         }
-        sparta_assert(lvrf_ways<=associativity, "Cannot disable more ways than the ones available in the cache bank!");
+        sparta_assert(config.lvrf_ways<=config.associativity, "Cannot disable more ways than the ones available in the cache bank!");
+
+        sparta_assert(config.vector_fill_policy=="normal" || config.vector_fill_policy=="low_priority" || config.vector_fill_policy=="reuse_predictor",
+            "The vector_fill_policy of the cache banks must be normal, low_priority or reuse_predictor");
+        if(config.vector_fill_policy=="low_priority")
+        {
+            vector_fill_policy_=VectorFillPolicy::LOW_PRIORITY;
+        }
+        else if(config.vector_fill_policy=="reuse_predictor")
+        {
+            vector_fill_policy_=VectorFillPolicy::REUSE_PREDICTOR;
+        }
+        sparta_assert(config.vector_way_quota<=config.associativity-config.lvrf_ways, "The vector way quota cannot be larger than the number of ways available in the cache bank!");
+
+        //Prefetchers work on the lines mapped to this bank, which are line_size*bank_and_tile_offset bytes apart
+        if(config.prefetcher=="next_line")
+        {
+            prefetcher_=std::make_unique<NextLinePrefetcher>(l2_line_size_*bank_and_tile_offset_, config.prefetch_degree);
+        }
+        else if(config.prefetcher=="stride")
+        {
+            prefetcher_=std::make_unique<StridePrefetcher>(l2_line_size_*bank_and_tile_offset_, config.prefetch_degree);
+        }
+        else if(config.prefetcher=="stream")
+        {
+            prefetcher_=std::make_unique<StreamPrefetcher>(l2_line_size_*bank_and_tile_offset_, config.prefetch_degree);
+        }
+        else
+        {
+            sparta_assert(config.prefetcher=="none", "The prefetcher of the cache banks must be none, next_line, stride or stream");
+        }
+
+        if(prefetcher_!=nullptr)
+        {
+            sparta_assert(config.max_outstanding_misses>1, "Prefetching requires at least two outstanding misses, as the last one is reserved for demand misses");
+            pollution_filter_.resize(POLLUTION_FILTER_SIZE, UINT64_MAX);
+        }
+
+        sparta_assert(config.access_mode=="serial" || config.access_mode=="parallel", "The access_mode of the cache banks must be serial or parallel");
+        if(config.tag_latency>0 || config.data_latency>0)
+        {
+            hit_latency_=serial_access_ ? config.tag_latency+config.data_latency : std::max(config.tag_latency, config.data_latency);
+        }
+        else
+        {
+            //Without separate tag and data latencies, a lookup takes hit_latency for both hits and misses
+            tag_latency_=hit_latency_;
+        }
+
+        //An initiation interval of 0 keeps the bank unpipelined: a lookup starts when the previous one finishes,
+        //and an idle bank starts a lookup as soon as it receives a request
+        if(!pipelined_)
+        {
+            initiation_interval_=hit_latency_;
+        }
+
+        if(config.lvrf_ways>0)
+        {
+            l2_cache_->disableWays(config.lvrf_ways);
+        }
+
+        if(config.stack_distance_profiling)
+        {
+            //The largest profiled size is reached with direct-mapped caches
+            uint64_t max_size_kb=(config.stack_distance_max_size_kb>0) ? config.stack_distance_max_size_kb : 4*config.size_kb;
+            stack_distance_profiler_=std::make_unique<StackDistanceProfiler>(l2_line_size_*bank_and_tile_offset_, config.stack_distance_sampling,
+                                                                             max_size_kb*1024/l2_line_size_, config.stack_distance_max_associativity);
+        }
+
+        sparta_assert(way_partitioner_.enabled() || config.way_partition_schedule.empty(), "Way partition changes require way_partitioning to be core or tile");
+        for(const std::string& change : config.way_partition_schedule)
+        {
+            size_t first=change.find(":");
+            size_t second=(first==std::string::npos) ? std::string::npos : change.find(":", first+1);
+            sparta_assert(second!=std::string::npos, "Way partition changes must be cycle:id:mask, got " << change);
+            uint16_t id=std::stoul(change.substr(first+1, second-first-1));
+            way_partition_schedule_.push_back(WayPartitionChange{std::stoull(change.substr(0, first)), id, std::stoull(change.substr(second+1), nullptr, 0)});
+            //Cores and tiles that only appear in the schedule can use all the ways until their first change
+            way_partitioner_.addPartition(id);
+        }
+        std::stable_sort(way_partition_schedule_.begin(), way_partition_schedule_.end(),
+                         [](const WayPartitionChange& a, const WayPartitionChange& b){ return a.cycle<b.cycle; });
+        if(!way_partition_schedule_.empty())
+        {
+            sparta::StartupEvent(node, CREATE_SPARTA_HANDLER(CacheBank, scheduleWayPartitionChanges_));
+        }
+
+        if(way_partitioner_.enabled())
+        {
+            partition_lines_.resize(way_partitioner_.size(), 0);
+            for(uint16_t i=0; i<way_partitioner_.size(); i++)
+            {
+                std::string name=way_partitioner_.getName(i);
+                count_partition_accesses_.push_back(sparta::Counter(getStatisticSet(), name+"_accesses", "Number of lookups of the way partition of "+name, sparta::Counter::COUNT_NORMAL));
+                count_partition_misses_.push_back(sparta::Counter(getStatisticSet(), name+"_misses", "Number of misses of the way partition of "+name, sparta::Counter::COUNT_NORMAL));
+                count_partition_evicted_by_others_.push_back(sparta::Counter(getStatisticSet(), name+"_evicted_by_others",
+                                                             "Number of lines of "+name+" evicted by the fills of another way partition", sparta::Counter::COUNT_NORMAL));
+                count_partition_occupancy_.push_back(sparta::Counter(getStatisticSet(), name+"_occupancy",
+                                                     "Sum of the lines held by "+name+" at each fill", sparta::Counter::COUNT_NORMAL));
+                partition_miss_ratio_.push_back(sparta::StatisticDef(getStatisticSet(), name+"_miss_ratio", "Miss ratio of "+name,
+                                                getStatisticSet(), name+"_misses/"+name+"_accesses"));
+                partition_avg_occupancy_.push_back(sparta::StatisticDef(getStatisticSet(), name+"_avg_occupancy", "Average number of lines held by "+name,
+                                                   getStatisticSet(), name+"_occupancy/partition_occupancy_samples"));
+            }
+        }
+    }
+
+    void CacheBank::setWayPartition(uint16_t id, uint64_t mask)
+    {
+        way_partitioner_.setMask(id, mask);
+        count_way_partition_changes_++;
+    }
+
+    void CacheBank::scheduleWayPartitionChanges_()
+    {
+        way_partition_event_.schedule(sparta::Clock::Cycle(way_partition_schedule_.front().cycle-getClock()->currentCycle()));
+    }
+
+    void CacheBank::applyWayPartitionChanges_()
+    {
+        uint64_t now=getClock()->currentCycle();
+        while(next_way_partition_change_<way_partition_schedule_.size() && way_partition_schedule_[next_way_partition_change_].cycle<=now)
+        {
+            const WayPartitionChange& change=way_partition_schedule_[next_way_partition_change_];
+            setWayPartition(change.id, change.mask);
+            next_way_partition_change_++;
+        }
 
-        if(lvrf_ways>0)
+        if(next_way_partition_change_<way_partition_schedule_.size())
         {
-            l2_cache_->disableWays(lvrf_ways);
+            way_partition_event_.schedule(sparta::Clock::Cycle(way_partition_schedule_[next_way_partition_change_].cycle-now));
         }
     }
 
@@ -85,7 +255,8 @@ namespace coyote
         //For write-back, stores are write allocate, so we have to reload the cache
         if((writeback_ && req->getType()!=CacheRequest::AccessType::WRITEBACK) || (!writeback_ && req->getType()!=CacheRequest::AccessType::STORE))
         {
-            reloadCache_(calculateLineAddress(req), req->getCacheBank(), req->getType(), req->getProducedByVector());
+            reloadCache_(calculateLineAddress(req), req->getCacheBank(), req->getType(), req->getProducedByVector(), req->getPC(), in_flight_misses_.onlyPrefetches(req),
+                         way_partitioner_.getPartition(req));
 
             auto range_misses=in_flight_misses_.equal_range(req);
             sparta_assert(range_misses.first != range_misses.second, "Got an ack for an unrequested miss\n");
@@ -93,8 +264,11 @@ namespace coyote
             while(range_misses.first != range_misses.second)
             {
                 range_misses.first->second->setServiced();
+                range_misses.first->second->setServiceLevel(req->getServiceLevel());
                 //The total time spent by requests is not updated here. This is for acks
-                if(!unit_test)
+                //The prefetches issued by this bank are not acknowledged, as no core is waiting for them.
+                //Prefetches issued by other levels (e.g. an L2 prefetch that misses in the LLC) are acknowledged to their issuer
+                if(!unit_test && !range_misses.first->second->isPrefetchIssuedBy(getContainer()))
                 {
                     out_core_ack_.send(range_misses.first->second);
                 }
@@ -102,10 +276,22 @@ namespace coyote
             }
 
             in_flight_misses_.erase(req);
+
+            auto pending=pending_coherence_.find((req->getAddress()/l2_line_size_)*l2_line_size_);
+            if(pending!=pending_coherence_.end())
+            {
+                applyCoherenceCommandToLine_(pending->first, pending->second, req->getCacheBank());
+                pending_coherence_.erase(pending);
+            }
         }
         else if(writeback_ && req->getType()!=CacheRequest::AccessType::STORE)
         {
-            if(num_in_flight_wbs==max_in_flight_wbs && pending_wb!=nullptr) //If it was stalled due to WBs
+            auto coherence_wb=in_flight_coherence_wbs_.find((req->getAddress()/l2_line_size_)*l2_line_size_);
+            if(coherence_wb!=in_flight_coherence_wbs_.end())
+            {
+                in_flight_coherence_wbs_.erase(coherence_wb);
+            }
+            else if(num_in_flight_wbs==max_in_flight_wbs && pending_wb!=nullptr) //If it was stalled due to WBs
             {
                 out_biu_req_.send(pending_wb, 1);                
                 pending_wb=nullptr;
@@ -116,13 +302,13 @@ namespace coyote
             }
         }
 
-        if(pending_fetch_requests_.size()+pending_load_requests_.size()+pending_store_requests_.size()+pending_scratchpad_requests_.size()>0)
+        if(pending_requests_.size()>0)
         {
             //ISSUE EVENT
             if(was_stalled && !busy_ && !in_flight_misses_.is_full() && pending_wb==nullptr)
             {
                 busy_=true;
-                scheduleIssueAccess(sparta::Clock::Cycle(0));
+                scheduleIssueAccess(sparta::Clock::Cycle(getIssueDelay_()));
             }
         }
         else
@@ -140,42 +326,34 @@ namespace coyote
     void CacheBank::issueAccessInternal_()
     {
         bool stall=false;
-        if(pending_scratchpad_requests_.size()>0) //Scratchpad requests are handled first
+        if(pipelined_)
+        {
+            next_issue_cycle_=getClock()->currentCycle()+initiation_interval_;
+        }
+        if(pending_requests_.hasScratchpadRequests()) //Scratchpad requests are handled first
         {
-            const std::shared_ptr<ScratchpadRequest> s=pending_scratchpad_requests_.front();
-            pending_scratchpad_requests_.pop_front(); //We always hit in the scratchpad. Nothing to check.
+            const std::shared_ptr<ScratchpadRequest> s=pending_requests_.popScratchpadRequest(); //We always hit in the scratchpad. Nothing to check.
 
             if(s->getCommand()==ScratchpadRequest::ScratchpadCommand::ALLOCATE)
             {
                 l2_cache_->disableWays(s->getSize());
+                enabled_ways_-=s->getSize();
             }
             else if(s->getCommand()==ScratchpadRequest::ScratchpadCommand::FREE)
             {
                 l2_cache_->enableWays(s->getSize());
+                enabled_ways_+=s->getSize();
             }
             s->setServiced();
             out_core_ack_.send(s, hit_latency_);
+            recordLookup_(true);
         }
         else
         {
-            MemoryAccessInfoPtr m;
-            if(pending_fetch_requests_.size()>0)
-            {
-                m=sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(memory_access_allocator, pending_fetch_requests_.front());   
-                pending_fetch_requests_.pop_front();
-            }
-            else if(pending_load_requests_.size()>0)
-            {
-                m=sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(memory_access_allocator, pending_load_requests_.front());  
-                pending_load_requests_.pop_front();
-            }
-            else if(pending_store_requests_.size()>0)
-            {
-                m=sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(memory_access_allocator, pending_store_requests_.front());
-                pending_store_requests_.pop_front();
-            }
+            //Fetches first, then loads and finally stores and writebacks
+            MemoryAccessInfoPtr m=sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(memory_access_allocator, pending_requests_.popCacheRequest());
  
-            handleCacheLookupReq_(m);
+            recordLookup_(handleCacheLookupReq_(m));
 
             if(in_flight_misses_.is_full() || pending_wb!=nullptr)
             {
@@ -184,9 +362,9 @@ namespace coyote
             }
         }
 
-        if(!stall && pending_wb==nullptr && (pending_fetch_requests_.size()+pending_load_requests_.size()+pending_store_requests_.size()+pending_scratchpad_requests_.size()>0)) //IF THERE ARE PENDING REQUESTS, SCHEDULE NEXT ISSUE
+        if(!stall && pending_wb==nullptr && pending_requests_.size()>0) //IF THERE ARE PENDING REQUESTS, SCHEDULE NEXT ISSUE
         {
-           scheduleIssueAccess(sparta::Clock::Cycle(hit_latency_)); //THE NEXT ACCESS CAN BE ISSUED AFTER THE SEARCH IN THE L2 HAS FINISHED (EITHER HIT OR MISS)
+           scheduleIssueAccess(sparta::Clock::Cycle(initiation_interval_)); //THE NEXT ACCESS CAN ENTER THE LOOKUP PIPELINE AFTER THE INITIATION INTERVAL
         }
         else
         {
@@ -198,15 +376,55 @@ namespace coyote
     bool CacheBank::handleCacheLookupReq_(const MemoryAccessInfoPtr & mem_access_info_ptr)
     {
         bool CACHE_HIT=true;
+        uint16_t partition=way_partitioner_.getPartition(mem_access_info_ptr->getReq());
+
+        //Lines received from another tile are allocated clean, unless they are already present or being fetched. No core waits for them
+        if(mem_access_info_ptr->getReq()->isFillOnly())
+        {
+            auto cache_line=l2_cache_->peekLine(mem_access_info_ptr->getRAdr());
+            if((cache_line==nullptr || !cache_line->isValid()) && !in_flight_misses_.contains(mem_access_info_ptr->getReq()))
+            {
+                reloadCache_(calculateLineAddress(mem_access_info_ptr->getReq()), mem_access_info_ptr->getReq()->getCacheBank(), CacheRequest::AccessType::LOAD, false, mem_access_info_ptr->getReq()->getPC(), false, partition);
+                count_remote_fills_++;
+            }
+            return true;
+        }
+
+        //Write-through stores do not allocate, so they are not part of the stream seen by the cache
+        if(stack_distance_profiler_!=nullptr && (writeback_ || mem_access_info_ptr->getReq()->getType()!=CacheRequest::AccessType::STORE))
+        {
+            stack_distance_profiler_->access(mem_access_info_ptr->getReq()->getAddress());
+        }
         if(mem_access_info_ptr->getReq()->getType()==CacheRequest::AccessType::WRITEBACK)
         {
-            reloadCache_(calculateLineAddress(mem_access_info_ptr->getReq()), mem_access_info_ptr->getReq()->getCacheBank(), mem_access_info_ptr->getReq()->getType(), mem_access_info_ptr->getReq()->getProducedByVector());
+            reloadCache_(calculateLineAddress(mem_access_info_ptr->getReq()), mem_access_info_ptr->getReq()->getCacheBank(), mem_access_info_ptr->getReq()->getType(), mem_access_info_ptr->getReq()->getProducedByVector(), mem_access_info_ptr->getReq()->getPC(), false, partition);
             CACHE_HIT=true;
         }
         else if(writeback_ || mem_access_info_ptr->getReq()->getType()!=CacheRequest::AccessType::STORE)
         {
             // Access cache, and check cache hit or miss
             CACHE_HIT = cacheLookup_(mem_access_info_ptr);
+
+            if(way_partitioner_.enabled())
+            {
+                count_partition_accesses_[partition]++;
+                if(!CACHE_HIT)
+                {
+                    count_partition_misses_[partition]++;
+                }
+            }
+
+            //A store that overwrites the whole line is allocated dirty without reading the line from the next level
+            if(!CACHE_HIT && writeback_ && isFullLineWrite_(mem_access_info_ptr->getReq()) && !in_flight_misses_.contains(mem_access_info_ptr->getReq()))
+            {
+                reloadCache_(calculateLineAddress(mem_access_info_ptr->getReq()), mem_access_info_ptr->getReq()->getCacheBank(), mem_access_info_ptr->getReq()->getType(), mem_access_info_ptr->getReq()->getProducedByVector(), mem_access_info_ptr->getReq()->getPC(), false, partition);
+                count_full_line_writes_++;
+                if(coherent_)
+                {
+                    requestExclusive_(mem_access_info_ptr->getReq());
+                }
+                CACHE_HIT=true;
+            }
         }
 
         if (CACHE_HIT)
@@ -220,7 +438,7 @@ namespace coyote
             total_time_spent_by_requests_=total_time_spent_by_requests_+(getClock()->currentCycle()+hit_latency_-mem_access_info_ptr->getReq()->getTimestampReachCacheBank());
             if(!writeback_ && mem_access_info_ptr->getReq()->getType()==CacheRequest::AccessType::STORE)
             {
-                out_biu_req_.send(crForWriteThrough, sparta::Clock::Cycle(hit_latency_));
+                writeThrough_(crForWriteThrough, hit_latency_);
             }
         }
         else 
@@ -246,9 +464,35 @@ namespace coyote
                 if(writeback_ || (mem_access_info_ptr->getReq()->getType() != CacheRequest::AccessType::STORE))
                 {
                     already_pending=in_flight_misses_.contains(mem_access_info_ptr->getReq());
+                    if(already_pending && in_flight_misses_.onlyPrefetches(mem_access_info_ptr->getReq()))
+                    {
+                        count_prefetches_late_++;
+                    }
                     in_flight_misses_.insert(mem_access_info_ptr->getReq());
                 }
 
+                if(prefetcher_!=nullptr && !already_pending)
+                {
+                    uint64_t line_addr=(mem_access_info_ptr->getReq()->getAddress()/l2_line_size_)*l2_line_size_;
+                    uint64_t& evicted_by_prefetch=pollutionFilterEntry_(line_addr);
+                    if(evicted_by_prefetch==line_addr)
+                    {
+                        count_prefetch_pollution_++;
+                        evicted_by_prefetch=UINT64_MAX;
+                    }
+                }
+
+                if(coherent_ && !already_pending)
+                {
+                    uint64_t line_addr=(mem_access_info_ptr->getReq()->getAddress()/l2_line_size_)*l2_line_size_;
+                    uint64_t& invalidated=coherenceFilterEntry_(line_addr);
+                    if(invalidated==line_addr)
+                    {
+                        count_coherence_misses_++;
+                        invalidated=UINT64_MAX;
+                    }
+                }
+
                 //MISSES ON LOADS AND FETCHES ARE ONLY FORWARDED IF THE LINE IS NOT ALREADY PENDING
                 if(!already_pending)
                 {
@@ -260,6 +504,14 @@ namespace coyote
                     } else {
                         crForMemoryPort = std::make_shared<CacheRequest>(*cache_req);
                     }
+
+                    //The buffered stores to the line must reach the next level before the miss
+                    uint64_t line_addr=write_combining_buffer_.getLine(cache_req->getAddress());
+                    if(write_combining_buffer_.contains(line_addr))
+                    {
+                        flushWriteCombiningLine_(line_addr);
+                        count_wcb_miss_flushes_++;
+                    }
                     out_biu_req_.send(cache_req, sparta::Clock::Cycle(miss_latency_));
 
                     if(mem_access_info_ptr->getReq()->getProducedByVector())
@@ -278,7 +530,7 @@ namespace coyote
                     if(!writeback_ && mem_access_info_ptr->getReq()->getType()==CacheRequest::AccessType::STORE)
                     {
                         std::shared_ptr<CacheRequest> crForWriteThrough = std::make_shared<CacheRequest>(*(mem_access_info_ptr->getReq()));
-                        out_biu_req_.send(crForWriteThrough, sparta::Clock::Cycle(miss_latency_));
+                        writeThrough_(crForWriteThrough, miss_latency_);
                     }
                     else
                     {
@@ -307,6 +559,12 @@ namespace coyote
                 }
             }
         }
+
+        if(prefetcher_!=nullptr && mem_access_info_ptr->getReq()->getType()!=CacheRequest::AccessType::WRITEBACK &&
+           (writeback_ || mem_access_info_ptr->getReq()->getType()!=CacheRequest::AccessType::STORE))
+        {
+            issuePrefetches_(mem_access_info_ptr->getReq(), !CACHE_HIT);
+        }
         return CACHE_HIT;
     }
 
@@ -317,6 +575,7 @@ namespace coyote
         uint64_t phyAddr = mem_access_info_ptr->getRAdr();
 
         bool cache_hit = false;
+        last_lookup_prefetch_hit_ = false;
 
         if (always_hit_) {
             cache_hit = true;
@@ -326,7 +585,25 @@ namespace coyote
             cache_hit = (cache_line != nullptr) && cache_line->isValid();
 
             if (cache_hit) {
-                l2_cache_->touchMRU(*cache_line);
+                l2_cache_->touchOnHit(*cache_line, mem_access_info_ptr->getReq()->getPC());
+                cache_line->setLastAccess(getClock()->currentCycle());
+
+                if(!cache_line->getReused() && cache_line->getFilledByVector() && isVectorReuseSampledSet_(phyAddr))
+                {
+                    count_sampled_vector_reuses_++;
+                    if(vector_reuse_counter_<VECTOR_REUSE_COUNTER_MAX)
+                    {
+                        vector_reuse_counter_++;
+                    }
+                }
+                cache_line->setReused(true);
+
+                last_lookup_prefetch_hit_=cache_line->getPrefetched();
+                if(cache_line->getPrefetched())
+                {
+                    count_prefetches_useful_++;
+                    cache_line->setPrefetched(false);
+                }
 
                 if(mem_access_info_ptr->getReq()->getProducedByVector())
                 {
@@ -340,6 +617,10 @@ namespace coyote
                 //SET DIRTY BIT IF NECESSARY
                 if((mem_access_info_ptr->getReq()->getType()==CacheRequest::AccessType::STORE || mem_access_info_ptr->getReq()->getType()==CacheRequest::AccessType::WRITEBACK) && writeback_)
                 {
+                    if(coherent_ && !cache_line->isModified())
+                    {
+                        requestExclusive_(mem_access_info_ptr->getReq());
+                    }
                     cache_line->setModified(true); //send the block to memory for write through l2
                 }
             }
@@ -361,9 +642,19 @@ namespace coyote
     }
 
     // Reload cache line
-    void CacheBank::reloadCache_(uint64_t phyAddr, uint16_t bank, CacheRequest::AccessType type, bool is_vector)
+    void CacheBank::reloadCache_(uint64_t phyAddr, uint16_t bank, CacheRequest::AccessType type, bool is_vector, uint64_t pc, bool is_prefetch, uint16_t partition)
     {
-        auto l2_cache_line = &l2_cache_->getLineForReplacementWithInvalidCheck(phyAddr);
+        //Only clean lines brought by vector loads are subject to the vector fill policy. Dirty lines must be allocated.
+        bool vector_fill=is_vector && type==CacheRequest::AccessType::LOAD;
+
+        if(vector_fill && vector_fill_policy_==VectorFillPolicy::REUSE_PREDICTOR &&
+           vector_reuse_counter_<=VECTOR_REUSE_COUNTER_MAX/2 && !isVectorReuseSampledSet_(phyAddr))
+        {
+            count_vector_bypasses_++;
+            return;
+        }
+
+        auto l2_cache_line = getLineForReplacement_(phyAddr, vector_fill, partition);
 
         //If the line is dirty, send a writeback to the memory
         if(l2_cache_line->isModified())
@@ -385,6 +676,34 @@ namespace coyote
 
         if(l2_cache_line->isValid())
         {
+            if(l2_cache_line->getPrefetched())
+            {
+                count_prefetches_useless_++;
+            }
+
+            if(is_prefetch)
+            {
+                pollutionFilterEntry_(l2_cache_line->getAddr())=l2_cache_line->getAddr();
+            }
+
+            if(way_partitioner_.enabled())
+            {
+                partition_lines_[l2_cache_line->getPartition()]--;
+                if(l2_cache_line->getPartition()!=partition)
+                {
+                    count_partition_evicted_by_others_[l2_cache_line->getPartition()]++;
+                }
+            }
+
+            if(l2_cache_line->getFilledByVector() && !l2_cache_line->getReused() && isVectorReuseSampledSet_(l2_cache_line->getAddr()))
+            {
+                count_sampled_vector_dead_evictions_++;
+                if(vector_reuse_counter_>0)
+                {
+                    vector_reuse_counter_--;
+                }
+            }
+
             if(is_vector)
             {
                 if(l2_cache_line->getAccessedByVector() && l2_cache_line->getAccessedByNonVector())
@@ -417,17 +736,39 @@ namespace coyote
             }
         }
 
-        l2_cache_->allocateWithMRUUpdate(*l2_cache_line, phyAddr);
+        l2_cache_->allocateWithFillUpdate(*l2_cache_line, phyAddr, pc);
                 
         if(is_vector)
         {
             l2_cache_line->setAccessedByVector(true);
+            l2_cache_line->setFilledByVector(true);
         }
         else
         {
             l2_cache_line->setAccessedByNonVector(true);
         }
 
+        l2_cache_line->setPrefetched(is_prefetch);
+        l2_cache_line->setPartition(partition);
+        l2_cache_line->setLastAccess(getClock()->currentCycle());
+
+        if(vector_fill && vector_fill_policy_==VectorFillPolicy::LOW_PRIORITY)
+        {
+            l2_cache_->touchLRU(*l2_cache_line);
+            l2_cache_line->setLastAccess(0); //Also the first victim within its way partition
+            count_vector_low_priority_fills_++;
+        }
+
+        if(way_partitioner_.enabled())
+        {
+            partition_lines_[partition]++;
+            count_partition_occupancy_samples_++;
+            for(uint16_t i=0; i<partition_lines_.size(); i++)
+            {
+                count_partition_occupancy_[i]+=partition_lines_[i];
+            }
+        }
+
         if(type == CacheRequest::AccessType::WRITEBACK || type == CacheRequest::AccessType::STORE)
             l2_cache_line->setModified(true); //Send the block to memory for write through L2
 
@@ -436,6 +777,277 @@ namespace coyote
         }
     }
 
+    bool CacheBank::isVectorReuseSampledSet_(uint64_t addr) const
+    {
+        return l2_cache_->getAddrDecoder()->calcIdx(addr)%VECTOR_REUSE_SAMPLING_INTERVAL==0;
+    }
+
+    SimpleCacheLine* CacheBank::getLineForReplacement_(uint64_t phyAddr, bool vector_fill, uint16_t partition)
+    {
+        auto l2_cache_line = &l2_cache_->getLineForReplacementWithInvalidCheck(phyAddr);
+
+        if(vector_fill && vector_way_quota_>0 && !(l2_cache_line->isValid() && l2_cache_line->getFilledByVector()))
+        {
+            //If the set already holds as many vector lines as the quota allows, replace one of them instead.
+            //Only the ways that are not disabled for the LVRF or the scratchpad are considered
+            SimpleCacheLine* vector_victim=nullptr;
+            uint64_t vector_lines=0;
+            for(auto & line : l2_cache_->getCacheSet(phyAddr))
+            {
+                if(line.getWay()<enabled_ways_ && line.isValid() && line.getFilledByVector())
+                {
+                    if(vector_victim==nullptr)
+                    {
+                        vector_victim=&line;
+                    }
+                    vector_lines++;
+                }
+            }
+
+            if(vector_lines>=vector_way_quota_)
+            {
+                l2_cache_line=vector_victim;
+                count_vector_quota_replacements_++;
+            }
+        }
+
+        if(way_partitioner_.enabled())
+        {
+            //Only the ways of the partition that are not disabled are eligible. If none is left, the partition is not enforced
+            uint64_t mask=way_partitioner_.getMask(partition) & (enabled_ways_>=64 ? UINT64_MAX : (uint64_t(1) << enabled_ways_)-1);
+            if(mask!=0 && ((mask >> l2_cache_line->getWay()) & 1)==0)
+            {
+                l2_cache_line=getPartitionVictim_(phyAddr, mask);
+                count_partition_victim_overrides_++;
+            }
+        }
+        return l2_cache_line;
+    }
+
+    SimpleCacheLine* CacheBank::getPartitionVictim_(uint64_t phyAddr, uint64_t mask)
+    {
+        SimpleCacheLine* victim=nullptr;
+        for(auto & line : l2_cache_->getCacheSet(phyAddr))
+        {
+            if(((mask >> line.getWay()) & 1)==0)
+            {
+                continue;
+            }
+            if(!line.isValid())
+            {
+                return &line;
+            }
+            if(victim==nullptr || line.getLastAccess()<victim->getLastAccess())
+            {
+                victim=&line;
+            }
+        }
+        return victim;
+    }
+
+    void CacheBank::issuePrefetches_(const std::shared_ptr<CacheRequest> & req, bool miss)
+    {
+        prefetch_candidates_.clear();
+        prefetcher_->notifyAccess((req->getAddress()/l2_line_size_)*l2_line_size_, req->getPC(), miss, last_lookup_prefetch_hit_, prefetch_candidates_);
+
+        for(uint64_t address : prefetch_candidates_)
+        {
+            auto line=l2_cache_->peekLine(address);
+            if((line!=nullptr && line->isValid()) || in_flight_misses_.contains(address))
+            {
+                continue;
+            }
+
+            //The last in flight miss entry is reserved for demand misses
+            if(in_flight_misses_.size()+1>=max_outstanding_misses_)
+            {
+                count_prefetches_dropped_++;
+                continue;
+            }
+
+            //The prefetched line is mapped to this bank, so it has the same home tile as the demand access
+            std::shared_ptr<CacheRequest> prefetch=std::make_shared<CacheRequest>(address, CacheRequest::AccessType::LOAD, req->getPC(), getClock()->currentCycle(), req->getCoreId());
+            prefetch->setCacheBank(req->getCacheBank());
+            prefetch->setHomeTile(req->getHomeTile());
+            prefetch->setSourceTile(req->getHomeTile());
+            prefetch->setPrefetch(getContainer());
+
+            in_flight_misses_.insert(prefetch);
+            out_biu_req_.send(prefetch, sparta::Clock::Cycle(miss_latency_));
+            count_prefetches_issued_++;
+        }
+    }
+
+    uint64_t& CacheBank::pollutionFilterEntry_(uint64_t line_addr)
+    {
+        uint64_t line=line_addr/l2_line_size_;
+        return pollution_filter_[(line ^ (line >> 10)) % POLLUTION_FILTER_SIZE];
+    }
+
+    uint64_t& CacheBank::coherenceFilterEntry_(uint64_t line_addr)
+    {
+        uint64_t line=line_addr/l2_line_size_;
+        return coherence_filter_[(line ^ (line >> 10)) % COHERENCE_FILTER_SIZE];
+    }
+
+    void CacheBank::applyCoherenceCommand_(const std::shared_ptr<CacheRequest> & r)
+    {
+        uint64_t line_addr=(r->getAddress()/l2_line_size_)*l2_line_size_;
+        if(in_flight_misses_.contains(line_addr))
+        {
+            //An invalidation overrides a forward on the same line
+            CacheRequest::CoherenceCommand& pending=pending_coherence_[line_addr];
+            if(pending!=CacheRequest::CoherenceCommand::INVALIDATE)
+            {
+                pending=r->getCoherenceCommand();
+            }
+            return;
+        }
+        applyCoherenceCommandToLine_(line_addr, r->getCoherenceCommand(), r->getCacheBank());
+    }
+
+    void CacheBank::applyCoherenceCommandToLine_(uint64_t line_addr, CacheRequest::CoherenceCommand command, uint16_t bank)
+    {
+        auto line=l2_cache_->peekLine(line_addr);
+        if(line==nullptr || !line->isValid())
+        {
+            return;
+        }
+
+        //The writeback is not held back by the limit of in flight writebacks, as the directory is waiting for it,
+        //so it is tracked apart and its ack does not release an eviction writeback
+        bool modified=line->isModified();
+        if(modified)
+        {
+            std::shared_ptr<CacheRequest> cache_req = std::make_shared<coyote::CacheRequest> (line->getAddr(), CacheRequest::AccessType::WRITEBACK, 0, getClock()->currentCycle(), 0);
+            cache_req->setCacheBank(bank);
+            cache_req->setSize(l2_line_size_);
+            out_biu_req_.send(cache_req, 1);
+            count_wbs_+=1;
+            in_flight_coherence_wbs_.insert((line->getAddr()/l2_line_size_)*l2_line_size_);
+            line->setModified(false);
+        }
+
+        if(command==CacheRequest::CoherenceCommand::INVALIDATE)
+        {
+            if(way_partitioner_.enabled())
+            {
+                partition_lines_[line->getPartition()]--;
+            }
+            l2_cache_->invalidateLine(*line);
+            coherenceFilterEntry_(line_addr)=line_addr;
+            count_coherence_invalidations_++;
+        }
+        else if(modified)
+        {
+            count_coherence_downgrades_++;
+        }
+    }
+
+    void CacheBank::requestExclusive_(const std::shared_ptr<CacheRequest> & req)
+    {
+        std::shared_ptr<CacheRequest> upgrade=std::make_shared<CacheRequest>(*req);
+        upgrade->setCoherenceCommand(CacheRequest::CoherenceCommand::GET_MODIFIED);
+        out_biu_req_.send(upgrade, 1);
+        count_coherence_upgrades_++;
+    }
+
+    void CacheBank::writeThrough_(const std::shared_ptr<CacheRequest> & req, uint16_t latency)
+    {
+        if(!write_combining_buffer_.enabled())
+        {
+            out_biu_req_.send(req, sparta::Clock::Cycle(latency));
+            return;
+        }
+
+        count_wcb_stores_++;
+        count_wcb_occupancy_+=write_combining_buffer_.size();
+        if(write_combining_buffer_.merge(req))
+        {
+            count_wcb_merges_++;
+            return;
+        }
+
+        if(write_combining_buffer_.isFull())
+        {
+            flushWriteCombiningLine_(write_combining_buffer_.oldest().line);
+            count_wcb_eviction_flushes_++;
+        }
+        write_combining_buffer_.allocate(req, getClock()->currentCycle());
+        if(write_combining_window_>0)
+        {
+            write_combining_flush_event_.schedule(sparta::Clock::Cycle(write_combining_window_));
+        }
+    }
+
+    void CacheBank::flushWriteCombiningLine_(uint64_t line)
+    {
+        WriteCombiningBuffer::Entry e=write_combining_buffer_.remove(line);
+
+        //A single write carries all the merged stores. It only has the size of a line if all its bytes were written,
+        //so the next level does not allocate a partially written line without reading it
+        std::shared_ptr<CacheRequest> write=std::make_shared<CacheRequest>(*e.req);
+        write->setAddress(line);
+        if(write_combining_buffer_.isFullyWritten(e))
+        {
+            write->setSize(l2_line_size_);
+            count_wcb_full_line_writes_++;
+        }
+        else
+        {
+            write->setSize(write_combining_buffer_.getWrittenBytes(e));
+        }
+        sparta_assert(write->getSize()>0, "Combined write of 0 bytes to line " << line);
+        out_biu_req_.send(write, 1);
+        count_wcb_writes_++;
+    }
+
+    void CacheBank::flushExpiredWriteCombiningLines_()
+    {
+        uint64_t now=getClock()->currentCycle();
+        while(!write_combining_buffer_.empty() && write_combining_buffer_.oldest().allocation_cycle+write_combining_window_<=now)
+        {
+            flushWriteCombiningLine_(write_combining_buffer_.oldest().line);
+            count_wcb_window_flushes_++;
+        }
+    }
+
+    bool CacheBank::flushWriteCombiningBuffer()
+    {
+        bool flushed=!write_combining_buffer_.empty();
+        while(!write_combining_buffer_.empty())
+        {
+            flushWriteCombiningLine_(write_combining_buffer_.oldest().line);
+            count_wcb_fence_flushes_++;
+        }
+        return flushed;
+    }
+
+    bool CacheBank::isFullLineWrite_(const std::shared_ptr<CacheRequest> & req)
+    {
+        return req->getType()==CacheRequest::AccessType::STORE && req->getSize()>=l2_line_size_ && req->getAddress()%l2_line_size_==0;
+    }
+
+    uint64_t CacheBank::getIssueDelay_()
+    {
+        uint64_t now=getClock()->currentCycle();
+        return (next_issue_cycle_>now) ? next_issue_cycle_-now : 0;
+    }
+
+    void CacheBank::recordLookup_(bool hit)
+    {
+        uint64_t now=getClock()->currentCycle();
+        uint64_t done=now+((hit || !serial_access_) ? hit_latency_ : tag_latency_);
+
+        count_lookups_++;
+        count_pipeline_lookup_cycles_+=done-now;
+        if(done>pipeline_busy_until_)
+        {
+            count_pipeline_busy_cycles_+=done-std::max(now, pipeline_busy_until_);
+            pipeline_busy_until_=done;
+        }
+    }
+
     uint64_t CacheBank::calculateLineAddress(std::shared_ptr<CacheRequest> r)
     {
         return (r->getAddress() >> l2_line_size_) << l2_line_size_;
@@ -443,7 +1055,11 @@ namespace coyote
 
     void CacheBank::handle(std::shared_ptr<coyote::CacheRequest> r)
     {
-        if(r->isServiced())
+        if(r->getCoherenceCommand()!=CacheRequest::CoherenceCommand::NONE)
+        {
+            applyCoherenceCommand_(r);
+        }
+        else if(r->isServiced())
         {
             sendAckInternal_(r);
         }
@@ -481,10 +1097,7 @@ namespace coyote
             if(r->getType()==CacheRequest::AccessType::LOAD)
             {
                 //CHECK FOR HITS ON PENDING WRITEBACK. STORES ARE NOT CHECKED. YOU NEED TO LOAD A WHOLE LINE, NOT JUST A WORD.
-                for (std::list<std::shared_ptr<CacheRequest>>::reverse_iterator rit=pending_store_requests_.rbegin(); rit!=pending_store_requests_.rend() && !hit_on_store; ++rit)
-                {
-                    hit_on_store=((*rit)->getType()==CacheRequest::AccessType::WRITEBACK && calculateLineAddress(*rit)==calculateLineAddress(r));
-                }
+                hit_on_store=pending_requests_.hasPendingWriteback(calculateLineAddress(r));
             }
 
             if(hit_on_store)
@@ -500,30 +1113,13 @@ namespace coyote
             }
             else
             {
-                switch(r->getType())
-                {
-                    case CacheRequest::AccessType::FETCH:
-                        pending_fetch_requests_.push_back(r);
-                        break;
-
-                    case CacheRequest::AccessType::LOAD:
-                        pending_load_requests_.push_back(r);
-                        break;
-
-                    case CacheRequest::AccessType::STORE:
-                        pending_store_requests_.push_back(r);
-                        break;
-
-                    case CacheRequest::AccessType::WRITEBACK:
-                        pending_store_requests_.push_back(r);
-                        break;
-                }
+                pending_requests_.push(r, calculateLineAddress(r));
 
                 if(!busy_ && !in_flight_misses_.is_full() && pending_wb==nullptr)
                 {
                     busy_=true;
                     //ISSUE EVENT
-                    scheduleIssueAccess(sparta::Clock::Cycle(0));
+                    scheduleIssueAccess(sparta::Clock::Cycle(getIssueDelay_()));
                 }
             }
         }
@@ -532,11 +1128,11 @@ namespace coyote
     void CacheBank::handle(std::shared_ptr<coyote::ScratchpadRequest> r)
     {
         count_scratchpad_requests_+=1;
-        pending_scratchpad_requests_.push_back(r);
+        pending_requests_.push(r);
         if(!busy_)
         {
             busy_=true;
-            scheduleIssueAccess(sparta::Clock::Cycle(0));
+            scheduleIssueAccess(sparta::Clock::Cycle(getIssueDelay_()));
         }
     }
 
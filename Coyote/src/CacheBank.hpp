@@ -39,14 +39,23 @@
 #include "sparta/utils/SpartaSharedPointerAllocator.hpp"
 
 #include "cache/TreePLRUReplacement.hpp"
+#include "cache_helpers/RRIPReplacement.hpp"
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "CacheRequest.hpp"
 #include "ScratchpadRequest.hpp"
 #include "SimpleDL2.hpp"
 #include "LogCapable.hpp"
 #include "SimulationEntryPoint.hpp"
+#include "PrefetcherIF.hpp"
+#include "PendingRequestQueue.hpp"
+#include "WriteCombiningBuffer.hpp"
+#include "WayPartitioner.hpp"
+#include "StackDistanceProfiler.hpp"
+
+#include <fstream>
 
 namespace coyote
 {
@@ -62,22 +71,82 @@ namespace coyote
          * be in service at the some time. Whether banks are shared or private to the tile is controlled from
          * the FullSystemSimulationFullSystemSimulationEventManager class. The Cache is write-back and write-allocate.
          *
+         * Lookups go through an in-order pipeline: a new one may start every initiation_interval_ cycles
+         * and takes hit_latency_ cycles, or only the tag latency for misses when the arrays are accessed serially.
+         *
+         * Write-through banks may merge their stores in a write-combining buffer. A buffered line is written to the
+         * next level when its window expires, when it is evicted to make room for another line or before a miss on it is forwarded.
+         *
+         * When the private L2s of the tiles are coherent, the bank applies the invalidations and forwards of the directory, writing
+         * back the modified lines, and notifies the directory when a store writes a clean line. Commands on lines that are still in
+         * flight are applied when the line arrives.
+         *
+         * The ways of the bank may be partitioned among the cores or tiles that share it. Lines are only allocated in the ways
+         * of the partition of the request that brings them. The masks of the partitions are set statically or changed at the
+         * cycles given in a schedule, or by other units through setWayPartition.
+         *
+         * A stack distance profiler may observe the accesses to the bank to write, at the end of the simulation, the miss ratio
+         * that LRU banks of every power-of-two size and associativity would have had.
+         *
          * This cache might return more than one ack in the same cycle if an access that corresponds to more than one request is serviced. 
          * External arbitration and queueing is necessary to avoid this behavior.
          *
          */
     public:
 
+        /*!
+         * \struct Config
+         * \brief The configuration of a cache bank, filled from the parameter set of each cache level.
+         * The defaults disable the optional features, so each level only sets the ones it supports
+         */
+        struct Config
+        {
+            bool always_hit=false;                                  //! The bank always hits
+            bool writeback=true;                                    //! Write-back and write-allocate, or write-through and no-write-allocate
+            uint16_t miss_latency=10;                               //! Cache miss latency
+            uint16_t hit_latency=10;                                //! Cache hit latency
+            uint16_t max_outstanding_misses=8;                      //! Maximum misses in flight to the next level
+            uint16_t max_in_flight_wbs=1;                           //! Maximum number of in flight wbs
+            bool unit_test=false;                                   //! The bank will be used in a unit testing scenario
+            uint64_t line_size=64;                                  //! Line size in bytes (power of 2)
+            uint64_t size_kb=64;                                    //! Size in KB (power of 2)
+            uint64_t associativity=8;                               //! Associativity (power of 2)
+            uint64_t lvrf_ways=0;                                   //! Ways disabled for the LVRF
+            uint32_t bank_and_tile_offset=1;                        //! The stride for banks and tiles, in lines
+            std::string replacement_policy="tree_plru";             //! tree_plru, srrip, brrip, drrip or ship
+            std::string vector_fill_policy="normal";                //! normal, low_priority or reuse_predictor
+            uint64_t vector_way_quota=0;                            //! Maximum ways of a set filled by vector loads (0 means no limit)
+            std::string prefetcher="none";                          //! none, next_line, stride or stream
+            uint16_t prefetch_degree=0;                             //! Lines prefetched on each trigger
+            uint16_t initiation_interval=0;                         //! Cycles between the start of two lookups (0 means not pipelined)
+            uint16_t tag_latency=0;                                 //! Latency of the tag array (0 with data_latency 0 means hit_latency)
+            uint16_t data_latency=0;                                //! Latency of the data array
+            std::string access_mode="serial";                       //! How the tag and data arrays are accessed (serial, parallel)
+            uint16_t write_combining_entries=0;                     //! Entries of the write-combining buffer of write-through banks
+            uint16_t write_combining_window=0;                      //! Cycles an entry may wait to combine stores (0 means no limit)
+            std::string way_partitioning="none";                    //! How the ways are partitioned (none, core, tile)
+            std::vector<std::string> way_partition_masks;           //! The ways of each core or tile, as id:mask
+            std::vector<std::string> way_partition_schedule;        //! Changes of the way partition masks, as cycle:id:mask
+            bool stack_distance_profiling=false;                    //! Write the miss ratio curves of the accesses to the bank
+            uint32_t stack_distance_sampling=32;                    //! One out of every stack_distance_sampling sets is profiled
+            uint64_t stack_distance_max_size_kb=0;                  //! The largest profiled size in KB (0 means 4 times size_kb)
+            uint64_t stack_distance_max_associativity=32;           //! The largest profiled associativity
+            std::string stack_distance_file_prefix="stack_distance_"; //! Prefix of the CSV file with the miss ratio curves
+        };
+
         /*!
          * \brief Constructor for CacheBank
          * \param node The node that represent the CacheBank and
-         * \param p The CacheBank parameter set
+         * \param config The configuration of the bank
          */
-        CacheBank(sparta::TreeNode* node, bool always_hit, bool is_writeback, uint16_t miss_latency, uint16_t hit_latency,
-                  uint16_t max_outstanding_misses, uint16_t max_in_flight_wbs, bool busy, bool unit_test, uint64_t line_size, uint64_t size_kb,
-                  uint64_t associativity, uint64_t lvrf_ways, uint32_t bank_and_tile_offset);
+        CacheBank(sparta::TreeNode* node, const Config& config);
 
         ~CacheBank() {
+            if(stack_distance_profiler_!=nullptr)
+            {
+                std::ofstream curves(stack_distance_file_);
+                stack_distance_profiler_->writeMissRatioCurves(curves, l2_line_size_);
+            }
             debug_logger_ << getContainer()->getLocation()
                           << ": "
                           << memory_access_allocator.getNumAllocated()
@@ -89,6 +158,15 @@ namespace coyote
         // Type Name/Alias Declaration
         ////////////////////////////////////////////////////////////////////////////////
 
+        /*!
+         * \brief How the lines brought by vector loads are inserted in the cache
+         */
+        enum class VectorFillPolicy
+        {
+            NORMAL,         //! Same as scalar lines
+            LOW_PRIORITY,   //! Inserted in the LRU position, so they are the next victim unless they are reused
+            REUSE_PREDICTOR //! Bypass the cache when the sampled sets show that vector lines are not reused
+        };
 
         class MemoryAccessInfo;
 
@@ -195,6 +273,32 @@ namespace coyote
             return bank_id_;
         }
 
+        /*!
+        * \brief Set whether the bank is kept coherent with the private L2s of the other tiles
+        * \param coherent True if the directory has to be notified
+        */
+        void setCoherent(bool coherent)
+        {
+            coherent_=coherent;
+            if(coherent_)
+            {
+                coherence_filter_.resize(COHERENCE_FILTER_SIZE, UINT64_MAX);
+            }
+        }
+
+        /*!
+        * \brief Change the ways in which the lines of a core or tile are allocated
+        * \param id The core or tile. It must have a way partition
+        * \param mask The ways of the partition. Lines already allocated outside them stay until they are replaced
+        */
+        void setWayPartition(uint16_t id, uint64_t mask);
+
+        /*!
+        * \brief Write all the lines of the write-combining buffer to the next level, as on a fence
+        * \return true if any line was written
+        */
+        bool flushWriteCombiningBuffer();
+
         /*!
          * \brief Handles a cache request
          * \param r The event to handle
@@ -258,6 +362,13 @@ namespace coyote
         uint16_t hit_latency_;
         uint16_t max_outstanding_misses_;
 
+        uint16_t tag_latency_;          //! Latency of the tag array. Misses leave the lookup pipeline after it in serial mode
+        bool serial_access_;            //! Whether the data array is accessed after the tag array (serial) or in parallel with it
+        uint16_t initiation_interval_;  //! Cycles between the start of two consecutive lookups
+        bool pipelined_;                //! Whether the lookups are pipelined. If not, an idle bank issues a request at once
+        uint64_t next_issue_cycle_;     //! First cycle in which the lookup pipeline accepts a new access
+        uint64_t pipeline_busy_until_;  //! Cycle in which the last lookup in the pipeline completes
+
         bool busy_;
         
         /*!
@@ -293,7 +404,53 @@ namespace coyote
         sparta::Counter count_non_vector_evicts_mixed_=sparta::Counter(getStatisticSet(), "non_vector_evicts_mixed", "Number of cache mixed line evictions caused by a non vector access", sparta::Counter::COUNT_NORMAL);
         
         sparta::Counter count_wbs_=sparta::Counter(getStatisticSet(), "writebacks", "Number of writebacks", sparta::Counter::COUNT_NORMAL);
+
+        sparta::Counter count_vector_bypasses_=sparta::Counter(getStatisticSet(), "vector_bypasses", "Number of vector lines that were not allocated due to the reuse predictor", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_vector_low_priority_fills_=sparta::Counter(getStatisticSet(), "vector_low_priority_fills", "Number of vector lines inserted with low priority", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_vector_quota_replacements_=sparta::Counter(getStatisticSet(), "vector_quota_replacements", "Number of vector fills that replaced a vector line because the set reached the vector way quota", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_sampled_vector_reuses_=sparta::Counter(getStatisticSet(), "sampled_vector_reuses", "Number of vector lines in the sampled sets that were reused", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_sampled_vector_dead_evictions_=sparta::Counter(getStatisticSet(), "sampled_vector_dead_evictions", "Number of vector lines in the sampled sets that were evicted without being reused", sparta::Counter::COUNT_NORMAL);
+
+        sparta::Counter count_remote_fills_=sparta::Counter(getStatisticSet(), "remote_fills", "Number of lines allocated after they were migrated or replicated from the bank of another tile", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_full_line_writes_=sparta::Counter(getStatisticSet(), "full_line_writes", "Number of store misses that overwrote a whole line and were allocated without reading it from the next level", sparta::Counter::COUNT_NORMAL);
+
+        sparta::Counter count_prefetches_issued_=sparta::Counter(getStatisticSet(), "prefetches_issued", "Number of prefetches sent to the next level", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_prefetches_dropped_=sparta::Counter(getStatisticSet(), "prefetches_dropped", "Number of prefetches dropped due to lack of free in-flight miss entries", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_prefetches_useful_=sparta::Counter(getStatisticSet(), "prefetches_useful", "Number of prefetched lines that were hit by a demand access", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_prefetches_late_=sparta::Counter(getStatisticSet(), "prefetches_late", "Number of demand misses on lines with an in-flight prefetch", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_prefetches_useless_=sparta::Counter(getStatisticSet(), "prefetches_useless", "Number of prefetched lines evicted before being demanded", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_prefetch_pollution_=sparta::Counter(getStatisticSet(), "prefetch_pollution", "Number of demand misses on lines that had been evicted by a prefetch", sparta::Counter::COUNT_NORMAL);
             
+        sparta::Counter count_wcb_stores_=sparta::Counter(getStatisticSet(), "wcb_stores", "Number of write-through stores that entered the write-combining buffer", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_merges_=sparta::Counter(getStatisticSet(), "wcb_merges", "Number of stores merged into a line already in the write-combining buffer", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_writes_=sparta::Counter(getStatisticSet(), "wcb_writes", "Number of combined writes sent to the next level", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_full_line_writes_=sparta::Counter(getStatisticSet(), "wcb_full_line_writes", "Number of combined writes that covered a whole line", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_window_flushes_=sparta::Counter(getStatisticSet(), "wcb_window_flushes", "Number of lines written because their window expired", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_eviction_flushes_=sparta::Counter(getStatisticSet(), "wcb_eviction_flushes", "Number of lines written to make room in a full write-combining buffer", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_miss_flushes_=sparta::Counter(getStatisticSet(), "wcb_miss_flushes", "Number of lines written before forwarding a miss on them", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_fence_flushes_=sparta::Counter(getStatisticSet(), "wcb_fence_flushes", "Number of lines written because of a fence or the end of the simulation", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_wcb_occupancy_=sparta::Counter(getStatisticSet(), "wcb_occupancy", "Sum of the occupancy of the write-combining buffer seen by each incoming store", sparta::Counter::COUNT_NORMAL);
+
+        sparta::Counter count_coherence_invalidations_=sparta::Counter(getStatisticSet(), "coherence_invalidations", "Number of valid lines invalidated by the directory", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_coherence_downgrades_=sparta::Counter(getStatisticSet(), "coherence_downgrades", "Number of modified lines written back and downgraded to shared by a forward of the directory", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_coherence_upgrades_=sparta::Counter(getStatisticSet(), "coherence_upgrades", "Number of writes to clean lines present in the bank that requested the exclusive permission of the directory", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_coherence_misses_=sparta::Counter(getStatisticSet(), "coherence_misses", "Number of demand misses on lines that had been invalidated by the directory", sparta::Counter::COUNT_NORMAL);
+
+        sparta::Counter count_lookups_=sparta::Counter(getStatisticSet(), "lookups", "Number of accesses that went through the lookup pipeline", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_pipeline_busy_cycles_=sparta::Counter(getStatisticSet(), "pipeline_busy_cycles", "Number of cycles with at least one lookup in the pipeline", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_pipeline_lookup_cycles_=sparta::Counter(getStatisticSet(), "pipeline_lookup_cycles", "Sum of the cycles spent in the pipeline by each lookup", sparta::Counter::COUNT_NORMAL);
+            
+        sparta::Counter count_way_partition_changes_=sparta::Counter(getStatisticSet(), "way_partition_changes", "Number of changes of the mask of a way partition", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_partition_victim_overrides_=sparta::Counter(getStatisticSet(), "partition_victim_overrides", "Number of fills in which the victim of the replacement policy was outside the way partition", sparta::Counter::COUNT_NORMAL);
+        sparta::Counter count_partition_occupancy_samples_=sparta::Counter(getStatisticSet(), "partition_occupancy_samples", "Number of fills in which the occupancy of the way partitions was sampled", sparta::Counter::COUNT_NORMAL);
+
+        std::vector<sparta::Counter> count_partition_accesses_;           //! Lookups of each way partition
+        std::vector<sparta::Counter> count_partition_misses_;             //! Misses of each way partition
+        std::vector<sparta::Counter> count_partition_evicted_by_others_;  //! Lines of each way partition evicted by the fills of another one
+        std::vector<sparta::Counter> count_partition_occupancy_;          //! Sum of the lines held by each way partition, sampled at each fill
+        std::vector<sparta::StatisticDef> partition_miss_ratio_;
+        std::vector<sparta::StatisticDef> partition_avg_occupancy_;
+
         sparta::Counter total_time_spent_by_requests_=sparta::Counter(getStatisticSet(), "total_time_spent_by_requests", "The total time spent by requests", sparta::Counter::COUNT_LATEST);
 
         sparta::StatisticDef avg_latency_lookup{
@@ -338,6 +495,36 @@ namespace coyote
             getStatisticSet(), "non_vector_misses/(non_vector_reads+non_vector_writes)"
         };
         
+        sparta::StatisticDef prefetch_accuracy_{
+            getStatisticSet(), "prefetch_accuracy",
+            "Fraction of the prefetches that were demanded (including late ones)",
+            getStatisticSet(), "(prefetches_useful+prefetches_late)/prefetches_issued"
+        };
+
+        sparta::StatisticDef prefetch_coverage_{
+            getStatisticSet(), "prefetch_coverage",
+            "Fraction of the misses without prefetching that were removed by timely prefetches",
+            getStatisticSet(), "prefetches_useful/(prefetches_useful+overall_misses)"
+        };
+
+        sparta::StatisticDef pipeline_occupancy_{
+            getStatisticSet(), "pipeline_occupancy",
+            "Average number of lookups in the pipeline while it is busy",
+            getStatisticSet(), "pipeline_lookup_cycles/pipeline_busy_cycles"
+        };
+
+        sparta::StatisticDef wcb_merge_ratio_{
+            getStatisticSet(), "wcb_merge_ratio",
+            "Fraction of the write-through stores merged in the write-combining buffer",
+            getStatisticSet(), "wcb_merges/wcb_stores"
+        };
+
+        sparta::StatisticDef wcb_avg_occupancy_{
+            getStatisticSet(), "wcb_avg_occupancy",
+            "Average number of lines in the write-combining buffer seen by an incoming store",
+            getStatisticSet(), "wcb_occupancy/wcb_stores"
+        };
+
         sparta::StatisticDef count_evictions_{
             getStatisticSet(), "total_evictions",
             "Total evictions",
@@ -383,11 +570,35 @@ namespace coyote
                     return misses_.find(getLine(req))!=misses_.end();
                 }
 
+                bool contains(uint64_t address)
+                {
+                    return misses_.find((address/line_size_)*line_size_)!=misses_.end();
+                }
+
+                //Whether all the in flight requests for the line of a request are prefetches
+                bool onlyPrefetches(std::shared_ptr<CacheRequest> req)
+                {
+                    auto range=misses_.equal_range(getLine(req));
+                    for(auto it=range.first; it!=range.second; ++it)
+                    {
+                        if(!it->second->isPrefetch())
+                        {
+                            return false;
+                        }
+                    }
+                    return range.first!=range.second;
+                }
+
                 bool is_full()
                 {
                     return misses_.size()==max_;
                 }
 
+                size_t size()
+                {
+                    return misses_.size();
+                }
+
             private:
                 std::unordered_multimap<uint64_t, std::shared_ptr<CacheRequest>> misses_;
                 uint64_t line_size_;
@@ -404,10 +615,32 @@ namespace coyote
         uint16_t num_in_flight_wbs;
         std::shared_ptr<CacheRequest> pending_wb;
 
-        std::list<std::shared_ptr<CacheRequest>> pending_fetch_requests_;
-        std::list<std::shared_ptr<CacheRequest>> pending_load_requests_;
-        std::list<std::shared_ptr<CacheRequest>> pending_store_requests_;
-        std::list<std::shared_ptr<ScratchpadRequest>> pending_scratchpad_requests_;
+        PendingRequestQueue pending_requests_;
+
+        WriteCombiningBuffer write_combining_buffer_; //! Disabled in write-back banks
+        uint16_t write_combining_window_;             //! Cycles a line stays in the buffer (0 means until it is evicted or flushed)
+
+        sparta::UniqueEvent<> write_combining_flush_event_
+            {&unit_event_set_, "write_combining_flush_event_", CREATE_SPARTA_HANDLER(CacheBank, flushExpiredWriteCombiningLines_)};
+
+        struct WayPartitionChange
+        {
+            uint64_t cycle;  //! Cycle of the bank clock in which the mask is changed
+            uint16_t id;     //! The core or tile
+            uint64_t mask;   //! The new mask
+        };
+
+        WayPartitioner way_partitioner_;
+        std::vector<uint64_t> partition_lines_;                    //! Valid lines held by each way partition
+        std::vector<WayPartitionChange> way_partition_schedule_;   //! Sorted by cycle
+        size_t next_way_partition_change_;
+        uint64_t enabled_ways_;                                    //! Ways not disabled for the LVRF or the scratchpad
+
+        std::unique_ptr<StackDistanceProfiler> stack_distance_profiler_; //! nullptr if profiling is disabled
+        std::string stack_distance_file_;                                 //! The CSV file with the miss ratio curves
+
+        sparta::UniqueEvent<> way_partition_event_
+            {&unit_event_set_, "way_partition_event_", CREATE_SPARTA_HANDLER(CacheBank, applyWayPartitionChanges_)};
         
         uint64_t l2_size_kb_;
         uint64_t l2_associativity_;
@@ -416,7 +649,142 @@ namespace coyote
 
         uint32_t bank_and_tile_offset_;
 
+        VectorFillPolicy vector_fill_policy_;
+        uint64_t vector_way_quota_;        //! The maximum number of vector lines in a set (0 means no limit)
+
+        static constexpr uint32_t VECTOR_REUSE_SAMPLING_INTERVAL=32; //! One out of every VECTOR_REUSE_SAMPLING_INTERVAL sets always allocates vector lines to train the predictor
+        static constexpr uint8_t VECTOR_REUSE_COUNTER_MAX=15;
+        uint8_t vector_reuse_counter_;     //! Saturating counter. Vector lines bypass the cache while it is below half its range
+
+        std::unique_ptr<PrefetcherIF> prefetcher_; //! nullptr if prefetching is disabled
+        std::vector<uint64_t> prefetch_candidates_;
+        bool last_lookup_prefetch_hit_;            //! Whether the last lookup was the first hit on a prefetched line
+
+        static constexpr uint32_t POLLUTION_FILTER_SIZE=1024;
+        std::vector<uint64_t> pollution_filter_;   //! Lines recently evicted by prefetches, indexed by a hash of the line
+
+        bool coherent_;
+        static constexpr uint32_t COHERENCE_FILTER_SIZE=1024;
+        std::vector<uint64_t> coherence_filter_;   //! Lines recently invalidated by the directory, indexed by a hash of the line
+        std::unordered_map<uint64_t, CacheRequest::CoherenceCommand> pending_coherence_; //! Commands on lines that are in flight
+        std::unordered_multiset<uint64_t> in_flight_coherence_wbs_; //! Lines of the writebacks requested by the directory, not limited by max_in_flight_wbs
+
         long long d;
+
+        /*!
+        * \brief Whether the set of an address is used to train the vector reuse predictor
+        * \param addr The address
+        * \return True if the set is sampled
+        */
+        bool isVectorReuseSampledSet_(uint64_t addr) const;
+
+        /*!
+        * \brief Select the line that will be replaced to allocate an address, enforcing the vector way quota and the way partitions
+        * \param phyAddr The address that will be allocated
+        * \param vector_fill Whether the line is brought by a vector load
+        * \param partition The way partition of the request that brings the line
+        * \return The line to replace
+        */
+        SimpleCacheLine* getLineForReplacement_(uint64_t phyAddr, bool vector_fill, uint16_t partition);
+
+        /*!
+        * \brief Select the line to replace among the ways of a partition: the first invalid one or else the least recently accessed
+        * \param phyAddr The address that will be allocated
+        * \param mask The ways of the partition
+        * \return The line to replace
+        */
+        SimpleCacheLine* getPartitionVictim_(uint64_t phyAddr, uint64_t mask);
+
+        /*!
+        * \brief Schedule the first change of the way partition schedule
+        */
+        void scheduleWayPartitionChanges_();
+
+        /*!
+        * \brief Apply the changes of the way partition schedule that are due and schedule the next one
+        */
+        void applyWayPartitionChanges_();
+
+        /*!
+        * \brief Train the prefetcher with a demand access and issue the prefetches it proposes
+        * \param req The demand access
+        * \param miss Whether the access missed
+        *
+        * Lines that are already present or in flight are not prefetched, and prefetches never take
+        * the last in-flight miss entry, which is left for demand misses.
+        */
+        void issuePrefetches_(const std::shared_ptr<CacheRequest> & req, bool miss);
+
+        /*!
+        * \brief Get the entry of the pollution filter for a line
+        * \param line_addr The address of the line
+        * \return The entry
+        */
+        uint64_t& pollutionFilterEntry_(uint64_t line_addr);
+
+        /*!
+        * \brief Get the entry of the coherence miss filter for a line
+        * \param line_addr The address of the line
+        * \return The entry
+        */
+        uint64_t& coherenceFilterEntry_(uint64_t line_addr);
+
+        /*!
+        * \brief Apply an invalidation or a forward of the directory, or defer it if the line is in flight
+        * \param r The command
+        */
+        void applyCoherenceCommand_(const std::shared_ptr<CacheRequest> & r);
+
+        /*!
+        * \brief Apply an invalidation or a forward of the directory to a line. Modified lines are written back
+        * \param line_addr The address of the line
+        * \param command INVALIDATE or FORWARD
+        * \param bank The bank that is written in the writeback
+        */
+        void applyCoherenceCommandToLine_(uint64_t line_addr, CacheRequest::CoherenceCommand command, uint16_t bank);
+
+        /*!
+        * \brief Notify the directory that a write needs the exclusive permission for a line that is not fetched from memory
+        * \param req The write
+        */
+        void requestExclusive_(const std::shared_ptr<CacheRequest> & req);
+
+        /*!
+        * \brief Whether a request is a store that overwrites a whole line, so the line can be allocated without reading it
+        * \param req The request
+        * \return True if the request is an aligned store of at least the size of a line
+        */
+        bool isFullLineWrite_(const std::shared_ptr<CacheRequest> & req);
+
+        /*!
+        * \brief Send a write-through store to the next level, merging it in the write-combining buffer if it is enabled
+        * \param req The copy of the store that is sent to the next level
+        * \param latency The cycles until the store leaves the bank
+        */
+        void writeThrough_(const std::shared_ptr<CacheRequest> & req, uint16_t latency);
+
+        /*!
+        * \brief Remove a line from the write-combining buffer and send a single write with all its merged stores
+        * \param line The address of the line
+        */
+        void flushWriteCombiningLine_(uint64_t line);
+
+        /*!
+        * \brief Flush the lines of the write-combining buffer whose window has expired
+        */
+        void flushExpiredWriteCombiningLines_();
+
+        /*!
+        * \brief Get the number of cycles until the lookup pipeline accepts a new access
+        * \return The number of cycles (0 if it can be issued now)
+        */
+        uint64_t getIssueDelay_();
+
+        /*!
+        * \brief Account an access entering the lookup pipeline in the current cycle
+        * \param hit Whether the access hit. In serial mode, misses do not access the data array
+        */
+        void recordLookup_(bool hit);
    
         virtual void logCacheRequest(std::shared_ptr<CacheRequest> r)=0;
 
@@ -442,8 +810,11 @@ namespace coyote
         /*!
         * \brief Update the replacement info for an address
         * \param The address to update
+        * \param pc The PC of the instruction that missed, used by the signature-based replacement policies
+        * \param is_prefetch Whether the line is brought by a prefetch that has not been demanded
+        * \param partition The way partition of the request that brings the line
         */
-        virtual void reloadCache_(uint64_t, uint16_t, CacheRequest::AccessType, bool is_vector);
+        virtual void reloadCache_(uint64_t, uint16_t, CacheRequest::AccessType, bool is_vector, uint64_t pc, bool is_prefetch, uint16_t partition);
     };
 
 
@@ -22,8 +22,14 @@
 
 #include "CacheDataMappingPolicy.hpp"
 #include "Request.hpp"
+#include "ServiceLevel.hpp"
 #include <iostream>
 
+namespace sparta
+{
+    class TreeNode;
+}
+
 namespace coyote
 {
     class CacheRequest : public Request, public std::enable_shared_from_this<CacheRequest>
@@ -50,6 +56,18 @@ namespace coyote
                 FETCH,
                 WRITEBACK,
             };
+
+            enum class CoherenceCommand
+            {
+                NONE,
+                GET_SHARED,
+                GET_MODIFIED,
+                PUT_MODIFIED,
+                INVALIDATE,
+                FORWARD,
+                ACK,
+                GRANT,
+            };
             
             //CacheRequest(){}
             CacheRequest() = delete;
@@ -194,6 +212,121 @@ namespace coyote
                 return produced_by_vector_instruction;
             }
 
+            /*!
+             * \brief Mark the request as a prefetch
+             * \param issuer The node of the unit that generated the prefetch (a cache bank or an MCPU)
+             */
+            void setPrefetch(const sparta::TreeNode* issuer)
+            {
+                prefetch_issuer=issuer;
+            }
+
+            /*!
+             * \brief Check if the request is a prefetch generated by a cache bank or an MCPU
+             * \return True if the request is a prefetch
+             */
+            bool isPrefetch()
+            {
+                return prefetch_issuer!=nullptr;
+            }
+
+            /*!
+             * \brief Check if the request is a prefetch generated by a unit. Only that unit drops its reply, the other levels service it as any other request
+             * \param unit The node of the unit
+             * \return True if the request is a prefetch issued by the unit
+             */
+            bool isPrefetchIssuedBy(const sparta::TreeNode* unit)
+            {
+                return prefetch_issuer!=nullptr && prefetch_issuer==unit;
+            }
+
+            /*!
+             * \brief Mark the request as a store that overwrites a whole line
+             */
+            void setFullLineWrite()
+            {
+                full_line_write=true;
+            }
+
+            /*!
+             * \brief Check if the request is a store that overwrites a whole line
+             * \return True if the previous contents of the line do not need to be read from memory
+             */
+            bool isFullLineWrite()
+            {
+                return full_line_write;
+            }
+
+            /*!
+             * \brief Mark a request serviced by a remote L2 so its line is allocated in the L2 of the requesting tile when the data reaches it
+             */
+            void setAllocateInSource()
+            {
+                allocate_in_source=true;
+            }
+
+            /*!
+             * \brief Check if the line of the request has to be allocated in the L2 of the requesting tile
+             * \return True if the line migrates or is replicated to the requesting tile
+             */
+            bool allocatesInSource()
+            {
+                return allocate_in_source;
+            }
+
+            /*!
+             * \brief Mark the request as the allocation of a line received from another tile
+             */
+            void setFillOnly()
+            {
+                fill_only=true;
+            }
+
+            /*!
+             * \brief Check if the request only allocates a line received from another tile
+             * \return True if the bank has to allocate the line without looking it up or acknowledging the request
+             */
+            bool isFillOnly()
+            {
+                return fill_only;
+            }
+
+            /*!
+             * \brief Set the coherence command carried by the request
+             * \param c The command. Requests that carry a command other than NONE are coherence messages and never reach memory
+             */
+            void setCoherenceCommand(CoherenceCommand c)
+            {
+                coherence_command=c;
+            }
+
+            /*!
+             * \brief Get the coherence command carried by the request
+             * \return The command
+             */
+            CoherenceCommand getCoherenceCommand()
+            {
+                return coherence_command;
+            }
+
+            /*!
+             * \brief Set the level of the memory hierarchy that serviced the request
+             * \param l The level
+             */
+            void setServiceLevel(ServiceLevel l)
+            {
+                service_level=l;
+            }
+
+            /*!
+             * \brief Get the level of the memory hierarchy that serviced the request
+             * \return The level. Requests that did not leave the tile are serviced by the L2
+             */
+            ServiceLevel getServiceLevel()
+            {
+                return service_level;
+            }
+
             /*
              * \brief Get the number of bytes that have been handled by memory for this cache request
              * \return The number of bytes handled by memory
@@ -248,6 +381,14 @@ namespace coyote
             bool misses_memory_row=false;
 
             bool produced_by_vector_instruction=false;
+            const sparta::TreeNode* prefetch_issuer=nullptr;
+            bool full_line_write=false;
+            bool allocate_in_source=false;
+            bool fill_only=false;
+
+            CoherenceCommand coherence_command=CoherenceCommand::NONE;
+
+            ServiceLevel service_level=ServiceLevel::L2;
 
             /*!
              * \brief Set the bank information of the memory access triggered by the CacheRequest
@@ -0,0 +1,165 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "sparta/utils/SpartaAssert.hpp"
+#include "CoherenceDirectory.hpp"
+
+namespace coyote
+{
+    CoherenceDirectory::CoherenceDirectory(uint16_t num_tiles, uint16_t max_pointers, uint32_t max_entries) :
+        num_tiles_(num_tiles),
+        max_pointers_(max_pointers==0 ? num_tiles : max_pointers),
+        max_entries_(max_entries),
+        entries_(),
+        lru_()
+    {
+        sparta_assert(max_entries_>0, "A directory slice needs at least one entry");
+    }
+
+    bool CoherenceDirectory::access(uint64_t line, uint16_t requester, CacheRequest::CoherenceCommand command, std::vector<Action>& actions)
+    {
+        bool broadcast=false;
+        switch(command)
+        {
+            case CacheRequest::CoherenceCommand::GET_SHARED:
+            {
+                Entry& e=getEntry_(line, actions);
+                if(e.modified)
+                {
+                    if(e.sharers[0]==requester)
+                    {
+                        break;
+                    }
+                    actions.push_back({e.sharers[0], CacheRequest::CoherenceCommand::FORWARD, line});
+                    e.modified=false;
+                }
+                addSharer_(e, requester);
+                break;
+            }
+
+            case CacheRequest::CoherenceCommand::GET_MODIFIED:
+            {
+                Entry& e=getEntry_(line, actions);
+                if(e.overflow)
+                {
+                    for(uint16_t t=0;t<num_tiles_;t++)
+                    {
+                        if(t!=requester)
+                        {
+                            actions.push_back({t, CacheRequest::CoherenceCommand::INVALIDATE, line});
+                        }
+                    }
+                    broadcast=true;
+                }
+                else
+                {
+                    for(uint16_t t : e.sharers)
+                    {
+                        if(t!=requester)
+                        {
+                            actions.push_back({t, CacheRequest::CoherenceCommand::INVALIDATE, line});
+                        }
+                    }
+                }
+                e.sharers.assign(1, requester);
+                e.modified=true;
+                e.overflow=false;
+                break;
+            }
+
+            case CacheRequest::CoherenceCommand::PUT_MODIFIED:
+            {
+                auto it=entries_.find(line);
+                if(it!=entries_.end() && it->second.modified && it->second.sharers[0]==requester)
+                {
+                    lru_.erase(it->second.lru_position);
+                    entries_.erase(it);
+                }
+                break;
+            }
+
+            default:
+                sparta_assert(false, "The directory only services GET_SHARED, GET_MODIFIED and PUT_MODIFIED requests");
+        }
+        return broadcast;
+    }
+
+    CoherenceDirectory::Entry& CoherenceDirectory::getEntry_(uint64_t line, std::vector<Action>& actions)
+    {
+        auto it=entries_.find(line);
+        if(it!=entries_.end())
+        {
+            lru_.splice(lru_.end(), lru_, it->second.lru_position);
+            return it->second;
+        }
+
+        if(entries_.size()==max_entries_)
+        {
+            //Every copy of the victim is invalidated, including a modified one, which is written back
+            uint64_t victim_line=lru_.front();
+            Entry& victim=entries_[victim_line];
+            if(victim.overflow)
+            {
+                for(uint16_t t=0;t<num_tiles_;t++)
+                {
+                    actions.push_back({t, CacheRequest::CoherenceCommand::INVALIDATE, victim_line});
+                }
+            }
+            else
+            {
+                for(uint16_t t : victim.sharers)
+                {
+                    actions.push_back({t, CacheRequest::CoherenceCommand::INVALIDATE, victim_line});
+                }
+            }
+            entries_.erase(victim_line);
+            lru_.pop_front();
+        }
+
+        Entry& e=entries_[line];
+        e.lru_position=lru_.insert(lru_.end(), line);
+        return e;
+    }
+
+    void CoherenceDirectory::addSharer_(Entry& e, uint16_t tile)
+    {
+        if(e.overflow)
+        {
+            return;
+        }
+
+        for(uint16_t t : e.sharers)
+        {
+            if(t==tile)
+            {
+                return;
+            }
+        }
+
+        if(e.sharers.size()<max_pointers_)
+        {
+            e.sharers.push_back(tile);
+        }
+        else
+        {
+            e.overflow=true;
+            e.sharers.clear();
+        }
+    }
+}
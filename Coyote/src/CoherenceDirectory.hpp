@@ -0,0 +1,113 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __COHERENCE_DIRECTORY_HH__
+#define __COHERENCE_DIRECTORY_HH__
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "CacheRequest.hpp"
+
+namespace coyote
+{
+    class CoherenceDirectory
+    {
+        /*!
+         * \class coyote::CoherenceDirectory
+         * \brief The slice of the MSI directory held by a home tile. Each entry tracks the tiles whose private L2
+         * holds a copy of a line, and whether one of them owns it in the modified state.
+         *
+         * In full_map mode the entries can track every tile. In limited_pointer mode an entry tracks up to
+         * max_pointers sharers, and once it overflows, invalidations of the line are broadcast to all the tiles.
+         * Clean evictions are silent, so an entry may keep stale sharers, which receive unnecessary invalidations.
+         * Entries are removed by the writeback of the owner, and when the slice is full the least recently used entry
+         * is evicted and every copy of its line is invalidated (a recall).
+         */
+        public:
+
+            /*!
+             * \brief A message that the directory sends to a tile to service a request
+             */
+            struct Action
+            {
+                uint16_t tile;                              //! The tile that receives the message
+                CacheRequest::CoherenceCommand command;     //! INVALIDATE or FORWARD
+                uint64_t line;                              //! The line of the request, or of the entry it recalls
+            };
+
+            /*!
+            * \brief Constructor for CoherenceDirectory
+            * \param num_tiles The number of tiles in the system
+            * \param max_pointers The number of sharers tracked by an entry. 0 tracks all the tiles (full_map)
+            * \param max_entries The number of entries of the slice
+            */
+            CoherenceDirectory(uint16_t num_tiles, uint16_t max_pointers, uint32_t max_entries);
+
+            /*!
+            * \brief Service a coherence request and update the entry of the line
+            * \param line The address of the line
+            * \param requester The tile that makes the request
+            * \param command GET_SHARED, GET_MODIFIED or PUT_MODIFIED
+            * \param actions The messages that the request requires, including the recall of an evicted entry, are appended here
+            * \return True if the invalidations were broadcast because the entry had overflowed
+            *
+            * A GET_SHARED on a modified line is forwarded to the owner, which writes the line back and keeps a shared copy.
+            * A GET_MODIFIED invalidates every other copy. A PUT_MODIFIED that does not come from the owner is stale and ignored.
+            */
+            bool access(uint64_t line, uint16_t requester, CacheRequest::CoherenceCommand command, std::vector<Action>& actions);
+
+            /*!
+            * \brief Get the number of lines with an entry in the directory
+            * \return The number of entries
+            */
+            size_t size() const {return entries_.size();}
+
+        private:
+            struct Entry
+            {
+                bool modified=false;            //! If true, sharers holds only the owner
+                bool overflow=false;            //! The sharers are unknown, so invalidations are broadcast
+                std::vector<uint16_t> sharers;
+                std::list<uint64_t>::iterator lru_position;
+            };
+
+            uint16_t num_tiles_;
+            uint16_t max_pointers_;
+            uint32_t max_entries_;
+            std::unordered_map<uint64_t, Entry> entries_;
+            std::list<uint64_t> lru_;       //! The lines of the entries, from the least to the most recently used
+
+            /*!
+            * \brief Get the entry of a line, allocating it if needed
+            * \param line The address of the line
+            * \param actions The invalidations of the entry evicted to make room are appended here
+            * \return The entry, which becomes the most recently used
+            */
+            Entry& getEntry_(uint64_t line, std::vector<Action>& actions);
+
+            /*!
+            * \brief Add a tile to the sharers of an entry
+            * \param e The entry
+            * \param tile The tile
+            */
+            void addSharer_(Entry& e, uint16_t tile);
+    };
+}
+#endif
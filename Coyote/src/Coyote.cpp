@@ -308,6 +308,26 @@ std::shared_ptr<coyote::FullSystemSimulationEventManager> Coyote::createRequestM
 
     m->setServicedRequestsStorage(s);
 
+    uint32_t access_profile_sampling=0;
+    uint64_t access_profile_interval=100000;
+    std::string access_profile_prefix="access_profile_";
+    if(upt.hasValue("meta.params.access_profile_sampling"))
+    {
+        access_profile_sampling=upt.get("meta.params.access_profile_sampling").getAs<uint32_t>();
+    }
+    if(upt.hasValue("meta.params.access_profile_interval"))
+    {
+        access_profile_interval=upt.get("meta.params.access_profile_interval").getAs<uint64_t>();
+    }
+    if(upt.hasValue("meta.params.access_profile_prefix"))
+    {
+        access_profile_prefix=upt.get("meta.params.access_profile_prefix").getAs<std::string>();
+    }
+    if(access_profile_sampling!=0)
+    {
+        m->enableAccessProfiling(access_profile_sampling, access_profile_interval, bank_line, access_profile_prefix);
+    }
+
     uint64_t mc_shift=0;
     uint64_t mc_mask=0;
     switch(address_mapping)
@@ -335,9 +355,13 @@ std::shared_ptr<coyote::FullSystemSimulationEventManager> Coyote::createRequestM
     }
     
     uint16_t num_vas_tiles_per_row=x_size-(num_memory_cpus/y_size);
+    std::shared_ptr<coyote::FirstTouchPageTable> page_table; //Only created if the tiles use the first_touch tile_policy
+    std::shared_ptr<coyote::DNUCALocationTable> dnuca_table; //Only created if lines may leave their home tile
     for(std::size_t i = 0; i < num_tiles; ++i)
     {
         tiles[i]->setRequestManager(m);
+        page_table=tiles[i]->sharePageTable(page_table);
+        dnuca_table=tiles[i]->shareDNUCATable(dnuca_table);
 
         // The corresponding MCPU is the closest in the same row.
         uint16_t row=i/num_vas_tiles_per_row;
@@ -496,6 +520,22 @@ double Coyote::getAvgNoCLatency()
                                     + 1.0 * getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.hop_count_" + remote_l2_ack_noc))->get()/getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.sent_packets_" + remote_l2_ack_noc))->get();
         res=((num_local_requests/total_requests)*avg_hop_count_local*hop_latency)+((num_remote_requests/total_requests)*avg_hop_count_remote*hop_latency);
     }
+    else if (noc_model == "analytical")
+    {
+        auto noc = getRoot()->getChild(std::string("arch.noc"))->getResourceAs<coyote::AnalyticalNoC>();
+        std::string remote_l2_request_noc = noc->getNetworkName(coyote::NoC::getNetworkForMessage(coyote::NoCMessageType::REMOTE_L2_REQUEST));
+        std::string remote_l2_ack_noc     = noc->getNetworkName(coyote::NoC::getNetworkForMessage(coyote::NoCMessageType::REMOTE_L2_ACK));
+        std::string mem_request_noc       = noc->getNetworkName(coyote::NoC::getNetworkForMessage(coyote::NoCMessageType::MEMORY_REQUEST_LOAD));
+        std::string mem_ack_noc           = noc->getNetworkName(coyote::NoC::getNetworkForMessage(coyote::NoCMessageType::MEMORY_ACK));
+
+        // The latency is tracked by network, not by type of message
+        double avg_latency_local = 1.0 * getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.packet_latency_" + mem_request_noc))->get()/getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.sent_packets_" + mem_request_noc))->get()
+                                 + 1.0 * getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.packet_latency_" + mem_ack_noc))->get()/getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.sent_packets_" + mem_ack_noc))->get();
+        double avg_latency_remote = avg_latency_local
+                                  + 1.0 * getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.packet_latency_" + remote_l2_request_noc))->get()/getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.sent_packets_" + remote_l2_request_noc))->get()
+                                  + 1.0 * getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.packet_latency_" + remote_l2_ack_noc))->get()/getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.sent_packets_" + remote_l2_ack_noc))->get();
+        res=((num_local_requests/total_requests)*avg_latency_local) + ((num_remote_requests/total_requests)*avg_latency_remote);
+    }
     else if (noc_model == "detailed")
     {
         double avg_latency_local = 1.0 * getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.packet_latency_MEMORY_REQUEST_LOAD"))->get()/getRoot()->getChildAs<sparta::Counter>(std::string("arch.noc.stats.num_MEMORY_REQUEST_LOAD"))->get()
@@ -0,0 +1,96 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+#ifndef __DNUCA_LOCATION_TABLE_HH__
+#define __DNUCA_LOCATION_TABLE_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace coyote
+{
+    /*!
+     * \class coyote::DNUCALocationTable
+     * \brief Tracks the lines of a shared L2 that have left their static home tile (D-NUCA).
+     *
+     * Each tracked line holds the tile where it currently lives, the tiles that hold a read-only replica
+     * of it and the run of consecutive remote hits of the last tile that requested it. Lines without an
+     * entry live in their static home. A single instance is shared by all the tiles.
+     */
+    class DNUCALocationTable
+    {
+        public:
+            struct Line
+            {
+                uint16_t location;              //! The tile that holds the line
+                uint16_t requester;             //! The last remote tile that hit on the line
+                uint16_t hits=0;                //! The consecutive remote hits of the requester
+                bool written=false;             //! Whether the line has been written since it was placed in its location
+                std::vector<uint16_t> replicas; //! The tiles with a read-only copy of the line
+
+                Line(uint16_t l) : location(l), requester(l), replicas(){}
+
+                /*!
+                * \brief Check if a tile holds a replica of the line
+                * \param tile The tile
+                * \return true if the tile holds a replica
+                */
+                bool hasReplica(uint16_t tile) const
+                {
+                    return std::find(replicas.begin(), replicas.end(), tile)!=replicas.end();
+                }
+            };
+
+            /*!
+            * \brief Get the entry of a line
+            * \param line The address of the line
+            * \return The entry, or nullptr if the line is in its static home and has no replicas
+            */
+            Line * find(uint64_t line)
+            {
+                auto it=lines_.find(line);
+                return it==lines_.end() ? nullptr : &it->second;
+            }
+
+            /*!
+            * \brief Get the entry of a line, creating it if the line is not tracked
+            * \param line The address of the line
+            * \param home The tile that holds the line if it is not tracked
+            * \return The entry
+            */
+            Line & get(uint64_t line, uint16_t home)
+            {
+                return lines_.emplace(line, Line(home)).first->second;
+            }
+
+            /*!
+            * \brief Get the number of tracked lines
+            * \return The number of lines
+            */
+            uint64_t size() const
+            {
+                return lines_.size();
+            }
+
+        private:
+            std::unordered_map<uint64_t, Line> lines_;
+    };
+}
+#endif
@@ -18,8 +18,9 @@
 // 
 
 #include "ExecutionDrivenSimulationOrchestrator.hpp"
+#include "utils.hpp"
 
-ExecutionDrivenSimulationOrchestrator::ExecutionDrivenSimulationOrchestrator(std::shared_ptr<coyote::SpikeWrapper>& spike, std::shared_ptr<Coyote>& coyote, std::shared_ptr<coyote::FullSystemSimulationEventManager>& request_manager, uint32_t num_cores, uint32_t num_threads_per_core, uint32_t thread_switch_latency, uint16_t num_mshrs_per_core, bool trace, bool l1_writeback, coyote::NoC* noc):
+ExecutionDrivenSimulationOrchestrator::ExecutionDrivenSimulationOrchestrator(std::shared_ptr<coyote::SpikeWrapper>& spike, std::shared_ptr<Coyote>& coyote, std::shared_ptr<coyote::FullSystemSimulationEventManager>& request_manager, uint32_t num_cores, uint32_t num_threads_per_core, uint32_t thread_switch_latency, uint16_t num_mshrs_per_core, bool trace, bool l1_writeback, coyote::NoC* noc, uint64_t cpi_stack_interval, const std::string& cpi_stack_file):
     spike(spike),
     coyote(coyote),
     request_manager(request_manager),
@@ -37,10 +38,19 @@ ExecutionDrivenSimulationOrchestrator::ExecutionDrivenSimulationOrchestrator(std
     l1_writeback(l1_writeback),
     is_fetch(false),
     noc_(noc),
-    noc_has_packets_in_flight_(false),
+    noc_next_delivery_cycle_(coyote::NoC::NO_PENDING_DELIVERY),
     max_in_flight_l1_misses(num_mshrs_per_core),
     in_flight_requests_per_l1(num_cores/num_threads_per_core),
-    mshr_stalls_per_core(num_cores)
+    mshr_stalls_per_core(num_cores),
+    stall_cycles_per_core(num_cores, StallCycles()),
+    stall_reason_per_core(num_cores, StallReason::MAX_REASONS),
+    stall_level_per_core(num_cores, ServiceLevel::NONE),
+    stall_start_per_core(num_cores, 0),
+    finish_cycle_per_core(num_cores, 0),
+    cpi_stack_interval(cpi_stack_interval),
+    last_cpi_stack_dump(0),
+    last_dumped_stall_cycles(num_cores, StallCycles()),
+    last_dumped_instructions(num_cores, 0)
 {
     for(uint16_t i=0;i<num_cores;i++)
     {
@@ -61,6 +71,25 @@ ExecutionDrivenSimulationOrchestrator::ExecutionDrivenSimulationOrchestrator(std
     waiting_on_fetch.resize(num_cores,false);
     waiting_on_mshrs.resize(num_cores,false);
     waiting_on_scalar_stores.resize(num_cores,false);
+
+    if(cpi_stack_interval!=0)
+    {
+        this->cpi_stack_file.open(cpi_stack_file);
+        sparta_assert(this->cpi_stack_file.is_open(), "Could not open the CPI stack file " << cpi_stack_file);
+        this->cpi_stack_file << "cycle;core;instructions;cycles";
+        for(size_t r=0;r<static_cast<size_t>(StallReason::MAX_REASONS);r++)
+        {
+            if(static_cast<StallReason>(r)!=StallReason::CORE_FINISHED)
+            {
+                this->cpi_stack_file << ";" << utils::reason_to_string(static_cast<StallReason>(r));
+            }
+        }
+        for(size_t l=0;l<static_cast<size_t>(ServiceLevel::MAX_LEVELS);l++)
+        {
+            this->cpi_stack_file << ";" << utils::service_level_to_string(static_cast<ServiceLevel>(l));
+        }
+        this->cpi_stack_file << std::endl;
+    }
 }
 
 void ExecutionDrivenSimulationOrchestrator::saveReports()
@@ -75,6 +104,12 @@ void ExecutionDrivenSimulationOrchestrator::saveReports()
         tot+=simulated_instructions_per_core[i];
     }
     printf("Total simulated instructions %lu\n", tot);
+
+    cpiStackReport();
+    if(cpi_stack_interval!=0)
+    {
+        dumpIntervalCPIStack();
+    }
     
     memoryAccessLatencyReport(); 
 }
@@ -82,6 +117,124 @@ void ExecutionDrivenSimulationOrchestrator::saveReports()
 ExecutionDrivenSimulationOrchestrator::~ExecutionDrivenSimulationOrchestrator()
 {
     saveReports();
+    if(cpi_stack_file.is_open())
+    {
+        cpi_stack_file.close();
+    }
+}
+
+void ExecutionDrivenSimulationOrchestrator::startStall(uint16_t core, StallReason reason)
+{
+    finishStall(core);
+    stall_reason_per_core[core]=reason;
+    stall_level_per_core[core]=ServiceLevel::NONE;
+    stall_start_per_core[core]=current_cycle;
+}
+
+void ExecutionDrivenSimulationOrchestrator::finishStall(uint16_t core)
+{
+    if(stall_reason_per_core[core]!=StallReason::MAX_REASONS)
+    {
+        stall_cycles_per_core[core][static_cast<size_t>(stall_reason_per_core[core])][static_cast<size_t>(stall_level_per_core[core])]+=current_cycle-stall_start_per_core[core];
+        stall_reason_per_core[core]=StallReason::MAX_REASONS;
+        stall_level_per_core[core]=ServiceLevel::NONE;
+    }
+}
+
+ServiceLevel ExecutionDrivenSimulationOrchestrator::getServiceLevel(const std::shared_ptr<coyote::CacheRequest>& r)
+{
+    ServiceLevel level=r->getServiceLevel();
+    //Requests serviced by the L2 of a tile different than the one of the core are remote hits
+    if(level==ServiceLevel::L2 && r->getHomeTile()!=r->getSourceTile())
+    {
+        level=ServiceLevel::REMOTE_L2;
+    }
+    return level;
+}
+
+void ExecutionDrivenSimulationOrchestrator::cpiStackReport()
+{
+    std::cout << "CPI stack (stall cycles are split by the level that serviced the blocking request):\n";
+    for(uint16_t i=0;i<num_cores;i++)
+    {
+        //Stalls that have not finished are accounted up to the current cycle
+        finishStall(i);
+
+        uint64_t instructions=simulated_instructions_per_core[i];
+        if(instructions==0)
+        {
+            continue;
+        }
+        uint64_t cycles=(finish_cycle_per_core[i]!=0) ? finish_cycle_per_core[i] : current_cycle;
+
+        uint64_t stalled=0;
+        for(auto& by_level : stall_cycles_per_core[i])
+        {
+            for(uint64_t c : by_level)
+            {
+                stalled+=c;
+            }
+        }
+
+        std::cout << "Core " << i << ": CPI " << (double)cycles/instructions << "\n";
+        std::cout << "\tbase: " << (double)(cycles-std::min(cycles, stalled))/instructions << "\n";
+        for(size_t r=0;r<static_cast<size_t>(StallReason::MAX_REASONS);r++)
+        {
+            uint64_t reason_cycles=0;
+            for(uint64_t c : stall_cycles_per_core[i][r])
+            {
+                reason_cycles+=c;
+            }
+            if(reason_cycles==0)
+            {
+                continue;
+            }
+
+            std::cout << "\t" << utils::reason_to_string(static_cast<StallReason>(r)) << ": " << (double)reason_cycles/instructions;
+            for(size_t l=0;l<static_cast<size_t>(ServiceLevel::MAX_LEVELS);l++)
+            {
+                if(stall_cycles_per_core[i][r][l]!=0)
+                {
+                    std::cout << " " << utils::service_level_to_string(static_cast<ServiceLevel>(l)) << "=" << (double)stall_cycles_per_core[i][r][l]/instructions;
+                }
+            }
+            std::cout << "\n";
+        }
+    }
+}
+
+void ExecutionDrivenSimulationOrchestrator::dumpIntervalCPIStack()
+{
+    //Stalls are accounted in the interval in which they finish
+    for(uint16_t i=0;i<num_cores;i++)
+    {
+        cpi_stack_file << current_cycle << ";" << i << ";" << simulated_instructions_per_core[i]-last_dumped_instructions[i] << ";" << current_cycle-last_cpi_stack_dump;
+
+        std::array<uint64_t, static_cast<size_t>(ServiceLevel::MAX_LEVELS)> level_cycles{};
+        for(size_t r=0;r<static_cast<size_t>(StallReason::MAX_REASONS);r++)
+        {
+            uint64_t reason_cycles=0;
+            for(size_t l=0;l<static_cast<size_t>(ServiceLevel::MAX_LEVELS);l++)
+            {
+                uint64_t c=stall_cycles_per_core[i][r][l]-last_dumped_stall_cycles[i][r][l];
+                reason_cycles+=c;
+                level_cycles[l]+=c;
+            }
+            if(static_cast<StallReason>(r)!=StallReason::CORE_FINISHED)
+            {
+                cpi_stack_file << ";" << reason_cycles;
+            }
+        }
+        for(uint64_t c : level_cycles)
+        {
+            cpi_stack_file << ";" << c;
+        }
+        cpi_stack_file << "\n";
+
+        last_dumped_stall_cycles[i]=stall_cycles_per_core[i];
+        last_dumped_instructions[i]=simulated_instructions_per_core[i];
+    }
+    last_cpi_stack_dump=current_cycle;
 }
 
 void ExecutionDrivenSimulationOrchestrator::memoryAccessLatencyReport()
@@ -159,6 +312,7 @@ void ExecutionDrivenSimulationOrchestrator::simulateInstInActiveCores()
         }
         else if(!hasFreeSlot)
         {
+            stall_reason=StallReason::ARBITER_FULL;
             stalled_cores_for_arbiter.insert(current_core);
         }
 
@@ -181,9 +335,11 @@ void ExecutionDrivenSimulationOrchestrator::simulateInstInActiveCores()
             {
                 //The core is not active and is not finished, so it goe into the stalled cores list
                 stalled_cores.push_back(current_core);
+                startStall(current_core, stall_reason);
             }
             else
             {
+                finish_cycle_per_core[current_core]=current_cycle;
                 //Core is not added back to any structure
                 //Spike has finished if all the cores have finished
                 if(active_cores.size()==0 && stalled_cores.size()==0)
@@ -279,7 +435,9 @@ void ExecutionDrivenSimulationOrchestrator::run()
 {
     //Each iteration of the loop handles a cycle
     //Simulation will end when there are neither pending events nor more instructions to simulate
-    while(!coyote->getScheduler()->isFinished() || !spike_finished || noc_has_packets_in_flight_)
+    //Then the lines left in the write-combining buffers are written, and the loop continues until their writes are serviced
+    while(!coyote->getScheduler()->isFinished() || !spike_finished || noc_next_delivery_cycle_!=coyote::NoC::NO_PENDING_DELIVERY ||
+          request_manager->flushWriteCombiningBuffers())
     {
         submittedCacheRequestsInThisCycle=0;
         simulateInstInActiveCores();
@@ -303,19 +461,31 @@ void ExecutionDrivenSimulationOrchestrator::run()
 
         // Execute one cycle of BookSim (it detailed model is used)
         noc_->runBookSimCycles(1);
-        noc_has_packets_in_flight_ = noc_->deliverOnePacketToDestination(current_cycle);
+        noc_next_delivery_cycle_ = noc_->deliverOnePacketToDestination(current_cycle);
         // BookSim can retire a packet and introduce an event that must be executed before the cycle saved in next_event_tick
         next_event_tick=coyote->getScheduler()->nextEventTick();
 
         selectRunnableThreads();
 
-        //If there are no active cores, booksim must not be executed at next cycle and there is a pending event
-        if(active_cores.size()==0 && !noc_has_packets_in_flight_ && next_event_tick!=sparta::Scheduler::INDEFINITE && (next_event_tick-current_cycle)>1 && !hasMsgInArbiter())
+        if(cpi_stack_interval!=0 && current_cycle-last_cpi_stack_dump>=cpi_stack_interval)
+        {
+            dumpIntervalCPIStack();
+        }
+
+        //The next cycle with work to do is the earliest of the next event and the next packet delivery of the NoC
+        uint64_t next_wakeup_cycle=next_event_tick;
+        if(next_wakeup_cycle==sparta::Scheduler::INDEFINITE || (noc_next_delivery_cycle_!=coyote::NoC::NO_PENDING_DELIVERY && noc_next_delivery_cycle_<next_wakeup_cycle))
+        {
+            next_wakeup_cycle=noc_next_delivery_cycle_;
+        }
+
+        //If there are no active cores, booksim must not be executed at next cycle and there is a pending event or packet delivery
+        if(active_cores.size()==0 && next_wakeup_cycle!=sparta::Scheduler::INDEFINITE && next_wakeup_cycle!=coyote::NoC::NO_PENDING_DELIVERY && next_wakeup_cycle>current_cycle+1 && !hasMsgInArbiter())
         {
             // Advance BookSim clock (if detailed model is used)
-            noc_->runBookSimCycles(next_event_tick-current_cycle-1); // -1 is because current cycle was executed above
-            //Advance the clock to the cycle for the event
-            current_cycle=next_event_tick;
+            noc_->runBookSimCycles(next_wakeup_cycle-current_cycle-1); // -1 is because current cycle was executed above
+            //Advance the clock to the cycle for the event or the packet delivery
+            current_cycle=next_wakeup_cycle;
         }
         else
         {
@@ -394,12 +564,18 @@ void ExecutionDrivenSimulationOrchestrator::submitToSparta(std::shared_ptr<coyot
     request_manager->putEvent(r);
 }
 
-bool ExecutionDrivenSimulationOrchestrator::resumeCore(uint64_t core)
+bool ExecutionDrivenSimulationOrchestrator::resumeCore(uint64_t core, ServiceLevel level)
 {
     std::vector<uint16_t>::iterator it;
 
     bool res=false;
 
+    //Remember who unblocked the core, it might not be resumed until there is space in the Arbiter Queue
+    if(level!=ServiceLevel::NONE && stall_reason_per_core[core]!=StallReason::MAX_REASONS)
+    {
+        stall_level_per_core[core]=level;
+    }
+
     //core should only be made active if there is space in the Arbiter Queue
     //This is a conservative approach. A performance efficient approach would be to activate the core and let it execute
     //instructions until it generates a packet for arbiter.
@@ -412,6 +588,7 @@ bool ExecutionDrivenSimulationOrchestrator::resumeCore(uint64_t core)
         {
             stalled_cores.erase(it);
             active_cores.push_back(core);
+            finishStall(core);
             res=true;
             if(trace_)
             {
@@ -461,6 +638,7 @@ void ExecutionDrivenSimulationOrchestrator::handle(std::shared_ptr<coyote::Cache
     else
     {
         uint16_t core=r->getCoreId();
+        ServiceLevel level=getServiceLevel(r);
         bool is_fetch=r->getType()==coyote::CacheRequest::AccessType::FETCH;
         bool is_load=r->getType()==coyote::CacheRequest::AccessType::LOAD;
         bool is_store=r->getType()==coyote::CacheRequest::AccessType::STORE;
@@ -605,7 +783,7 @@ void ExecutionDrivenSimulationOrchestrator::handle(std::shared_ptr<coyote::Cache
             if(!spike->checkInFlightScalarStores(core) && waiting_on_scalar_stores[core])
             {
                 waiting_on_scalar_stores[core]=false;
-                resumeCore(core);
+                resumeCore(core, level);
             }
         }
     
@@ -613,14 +791,14 @@ void ExecutionDrivenSimulationOrchestrator::handle(std::shared_ptr<coyote::Cache
         if(waiting_on_mshrs[core] && pending_misses_per_core[core].size()==0)
         {
             waiting_on_mshrs[core]=false;
-            resumeCore(core);
+            resumeCore(core, level);
         }
 
 
         //If there are MSHRs available, the core is not in a barrier and either a RAW was serviced or MSHRs just became available
         if(can_run && !threads_in_barrier[core] && !waiting_on_mshrs[core]) //The new version of resume in coherence probably already does something similar
         {
-            bool resumed=resumeCore(core);
+            bool resumed=resumeCore(core, level);
             if(trace_ && resumed)
             {
                 logger_->logResumeWithAddress(current_cycle, core, r->getAddress());
@@ -672,6 +850,9 @@ void ExecutionDrivenSimulationOrchestrator::handle(std::shared_ptr<coyote::Vecto
 
 void ExecutionDrivenSimulationOrchestrator::runPendingSimfence(uint64_t core)
 {
+    //The stores buffered before the fence are written to the next level
+    request_manager->flushWriteCombiningBuffers();
+
     //set the thread_barrier_cnt to number of threads, if not already set
     if(thread_barrier_cnt == 0)
     {
@@ -24,6 +24,8 @@
 #include <memory>
 #include <set>
 #include <map>
+#include <array>
+#include <fstream>
 
 #include "spike_wrapper.h"
 #include "FullSystemSimulationEventManager.hpp"
@@ -39,6 +41,7 @@
 #include "LogCapable.hpp"
 #include "SimulationOrchestrator.hpp"
 #include "StallReason.hpp"
+#include "ServiceLevel.hpp"
 #include "NoC/NoC.hpp"
 
 class ExecutionDrivenSimulationOrchestrator : public SimulationOrchestrator, public coyote::EventVisitor
@@ -68,8 +71,10 @@ class ExecutionDrivenSimulationOrchestrator : public SimulationOrchestrator, pub
          * \param trace Whether tracing is enabled or not
          * \param l1_writeback Whether l1 is writeback or writethrough
          * \param noc A pointer to the simulated NoC
+         * \param cpi_stack_interval The number of cycles between two dumps of the interval CPI stack (0 disables them)
+         * \param cpi_stack_file The file where the interval CPI stacks are written
          */
-        ExecutionDrivenSimulationOrchestrator(std::shared_ptr<coyote::SpikeWrapper>& spike, std::shared_ptr<Coyote>& coyote, std::shared_ptr<coyote::FullSystemSimulationEventManager>& request_manager, uint32_t num_cores, uint32_t num_threads_per_core, uint32_t thread_switch_latency, uint16_t num_mshrs_per_core, bool trace, bool l1_writeback, coyote::NoC* noc);
+        ExecutionDrivenSimulationOrchestrator(std::shared_ptr<coyote::SpikeWrapper>& spike, std::shared_ptr<Coyote>& coyote, std::shared_ptr<coyote::FullSystemSimulationEventManager>& request_manager, uint32_t num_cores, uint32_t num_threads_per_core, uint32_t thread_switch_latency, uint16_t num_mshrs_per_core, bool trace, bool l1_writeback, coyote::NoC* noc, uint64_t cpi_stack_interval=0, const std::string& cpi_stack_file="cpi_stack.csv");
 
         /*!
          * \brief Destructor for ExecutionDrivenSimulationOrchestrator
@@ -173,7 +178,7 @@ class ExecutionDrivenSimulationOrchestrator : public SimulationOrchestrator, pub
         bool is_fetch;
 
         coyote::NoC* noc_;    //! Pointer to the NoC
-        bool noc_has_packets_in_flight_;        //! Flag that indicates if the noc has packets in flight
+        uint64_t noc_next_delivery_cycle_;      //! The next cycle in which the noc has to deliver a packet, NO_PENDING_DELIVERY if there are no packets in flight
         std::set<uint16_t> stalled_cores_for_arbiter;
         
         uint16_t max_in_flight_l1_misses;
@@ -187,6 +192,21 @@ class ExecutionDrivenSimulationOrchestrator : public SimulationOrchestrator, pub
 
         uint16_t submittedCacheRequestsInThisCycle;
 
+        //! Stall cycles of a core, indexed by [StallReason][ServiceLevel]
+        using StallCycles=std::array<std::array<uint64_t, static_cast<size_t>(ServiceLevel::MAX_LEVELS)>, static_cast<size_t>(StallReason::MAX_REASONS)>;
+
+        std::vector<StallCycles> stall_cycles_per_core; //(num_cores);
+        std::vector<StallReason> stall_reason_per_core; //(num_cores) The reason of the ongoing stall. MAX_REASONS if the core is not stalled
+        std::vector<ServiceLevel> stall_level_per_core; //(num_cores) The level that serviced the request that unblocks the ongoing stall
+        std::vector<uint64_t> stall_start_per_core; //(num_cores);
+        std::vector<uint64_t> finish_cycle_per_core; //(num_cores) 0 while the core is running
+
+        uint64_t cpi_stack_interval;
+        uint64_t last_cpi_stack_dump;
+        std::ofstream cpi_stack_file;
+        std::vector<StallCycles> last_dumped_stall_cycles; //(num_cores);
+        std::vector<uint64_t> last_dumped_instructions; //(num_cores);
+
         /*!
          * \brief Simulate an instruction in each of the active cores
          */
@@ -225,8 +245,39 @@ class ExecutionDrivenSimulationOrchestrator : public SimulationOrchestrator, pub
         /*
          * \brief Resume simulation on a core that is stalled
          * \param core The id of the core that will resume simulation
+         * \param level The level of the memory hierarchy that serviced the request unblocking the core
+         */
+        bool resumeCore(uint64_t core, ServiceLevel level=ServiceLevel::NONE);
+
+        /*!
+         * \brief Start accounting a stall for a core
+         * \param core The stalled core
+         * \param reason The reason of the stall
+         */
+        void startStall(uint16_t core, StallReason reason);
+
+        /*!
+         * \brief Finish the ongoing stall of a core and accumulate its cycles
+         * \param core The resumed core
+         */
+        void finishStall(uint16_t core);
+
+        /*!
+         * \brief Get the level that serviced a cache request from the point of view of its core
+         * \param r The serviced request
+         * \return The level, distinguishing the local and the remote L2
+         */
+        ServiceLevel getServiceLevel(const std::shared_ptr<coyote::CacheRequest>& r);
+
+        /*!
+         * \brief Print the CPI stack of each core
+         */
+        void cpiStackReport();
+
+        /*!
+         * \brief Append the stall cycles accounted since the previous dump to the interval CPI stack file
          */
-        bool resumeCore(uint64_t core);
+        void dumpIntervalCPIStack();
 
         /*
          * \brief Submit the pending operations of any kind to sparta
@@ -0,0 +1,108 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+#ifndef __FIRST_TOUCH_PAGE_TABLE_HH__
+#define __FIRST_TOUCH_PAGE_TABLE_HH__
+
+#include <cstdint>
+#include <unordered_map>
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace coyote
+{
+    /*!
+     * \class coyote::FirstTouchPageTable
+     * \brief Places the pages of a shared L2 in the tiles like an OS with a first-touch policy.
+     *
+     * The first tile that accesses a page becomes its home. If shared pages are interleaved, a page
+     * that is later accessed by a different tile is no longer homed in a single tile and its lines are
+     * interleaved among all the tiles from then on. A single instance is shared by all the tiles.
+     */
+    class FirstTouchPageTable
+    {
+        public:
+            enum class Placement
+            {
+                FIRST_TOUCH, //! The access placed the page in its tile
+                PRIVATE,     //! The page was already placed in a tile
+                NEW_SHARED,  //! The access made the page shared
+                SHARED       //! The page was already shared
+            };
+
+            /*!
+            * \brief Constructor for FirstTouchPageTable
+            * \param page_size The size of the pages in bytes. Must be a power of two
+            * \param interleave_shared Whether pages accessed by more than one tile are interleaved among all the tiles
+            */
+            FirstTouchPageTable(uint64_t page_size, bool interleave_shared) :
+                page_bits_(0),
+                interleave_shared_(interleave_shared),
+                pages_()
+            {
+                sparta_assert(page_size>0 && (page_size & (page_size-1))==0, "The page size of the first touch page table must be a power of two");
+                while((uint64_t(1) << page_bits_)<page_size)
+                {
+                    page_bits_++;
+                }
+            }
+
+            /*!
+            * \brief Look up the home of the page of an address, placing it if it has not been accessed before
+            * \param address The address
+            * \param tile The tile that accesses the address
+            * \param home The home tile of the page. Only valid if the page is not shared
+            * \return How the page is placed
+            */
+            Placement access(uint64_t address, uint16_t tile, uint16_t & home)
+            {
+                auto res=pages_.emplace(address >> page_bits_, tile);
+                home=res.first->second;
+                if(res.second)
+                {
+                    return Placement::FIRST_TOUCH;
+                }
+                if(home==SHARED_PAGE)
+                {
+                    return Placement::SHARED;
+                }
+                if(home!=tile && interleave_shared_)
+                {
+                    res.first->second=SHARED_PAGE;
+                    return Placement::NEW_SHARED;
+                }
+                return Placement::PRIVATE;
+            }
+
+            /*!
+            * \brief Get the number of pages that have been accessed
+            * \return The number of pages
+            */
+            uint64_t size() const
+            {
+                return pages_.size();
+            }
+
+        private:
+            static constexpr uint16_t SHARED_PAGE=UINT16_MAX;
+
+            uint8_t page_bits_;
+            bool interleave_shared_;
+            std::unordered_map<uint64_t, uint16_t> pages_; //! Page number to home tile, or SHARED_PAGE
+    };
+}
+#endif
@@ -58,6 +58,36 @@ namespace coyote
         tiles_[source]->putEvent(r);
     }
 
+    void FullSystemSimulationEventManager::handle(std::shared_ptr<coyote::CacheRequest> r)
+    {
+        if(access_profiler_!=nullptr)
+        {
+            access_profiler_->access(r->getAddress(), r->getPC(), r->getTimestamp());
+        }
+        handle(std::dynamic_pointer_cast<coyote::CoreEvent>(r));
+    }
+
+    void FullSystemSimulationEventManager::enableAccessProfiling(uint32_t sampling, uint64_t interval, uint64_t line_size, const std::string& prefix)
+    {
+        access_profiler_=std::make_unique<AccessProfiler>(sampling, interval, line_size, prefix);
+    }
+
+    bool FullSystemSimulationEventManager::flushWriteCombiningBuffers()
+    {
+        bool flushed=false;
+        for(auto itr = tiles_.begin(); itr != tiles_.end(); itr++)
+        {
+            for(uint16_t i = 0; i < (*itr)->getL2Banks(); i++)
+            {
+                if((*itr)->getArbiter()->getBank(i)->flushWriteCombiningBuffer())
+                {
+                    flushed=true;
+                }
+            }
+        }
+        return flushed;
+    }
+
     void FullSystemSimulationEventManager::scheduleArbiter()
     {
         for(auto itr = tiles_.begin(); itr != tiles_.end(); itr++)
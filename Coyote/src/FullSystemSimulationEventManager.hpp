@@ -29,6 +29,7 @@
 #include "Event.hpp"
 #include "MemoryTile/MCPUSetVVL.hpp"
 #include "SimulationEntryPoint.hpp"
+#include "AccessProfiler.hpp"
 
 class Coyote; //Forward declaration
 class ExecutionDrivenSimulationOrchestrator;
@@ -90,6 +91,21 @@ namespace coyote
              */
             std::shared_ptr<Event> getServicedRequest();
 
+            /*!
+             * \brief Profile the reuse distance and the working set of the cache requests that reach the L2
+             * \param sampling One out of every sampling lines is profiled
+             * \param interval The number of cycles of each interval of the working set (0 disables it)
+             * \param line_size The size of a line in bytes
+             * \param prefix The prefix of the CSV files where the profile is written when the manager is destroyed
+             */
+            void enableAccessProfiling(uint32_t sampling, uint64_t interval, uint64_t line_size, const std::string& prefix);
+
+            /*!
+             * \brief Write the lines buffered in the write-combining buffers of all the L2 banks to the next level
+             * \return true if any line was written
+             */
+            bool flushWriteCombiningBuffers();
+
             void scheduleArbiter();
             bool hasMsgInArbiter();
             bool hasArbiterQueueFreeSlot(uint16_t core);
@@ -101,6 +117,7 @@ namespace coyote
         
         private:
             ServicedRequests serviced_requests_;
+            std::unique_ptr<AccessProfiler> access_profiler_; //! nullptr if profiling is disabled
             
             
             /*!
@@ -119,6 +136,12 @@ namespace coyote
              * \param r The event to handle
              */
             virtual void handle(std::shared_ptr<coyote::CoreEvent> r) override;
+
+             /*!
+             * \brief Handles a cache request, profiling it if enabled
+             * \param r The event to handle
+             */
+            virtual void handle(std::shared_ptr<coyote::CacheRequest> r) override;
             
     };
 }
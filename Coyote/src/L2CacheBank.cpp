@@ -26,14 +26,52 @@ namespace coyote
 {
     const char L2CacheBank::name[] = "l2";
 
+    namespace
+    {
+        CacheBank::Config getCacheBankConfig(const L2CacheBank::L2CacheBankParameterSet* p)
+        {
+            CacheBank::Config config;
+            config.always_hit=p->always_hit;
+            config.writeback=p->writeback;
+            config.miss_latency=p->miss_latency;
+            config.hit_latency=p->hit_latency;
+            config.max_outstanding_misses=p->max_outstanding_misses;
+            config.max_in_flight_wbs=p->max_outstanding_wbs;
+            config.unit_test=p->unit_test;
+            config.line_size=p->line_size;
+            config.size_kb=p->size_kb;
+            config.associativity=p->associativity;
+            config.lvrf_ways=p->lvrf_ways;
+            config.bank_and_tile_offset=p->bank_and_tile_offset;
+            config.replacement_policy=p->replacement_policy;
+            config.vector_fill_policy=p->vector_fill_policy;
+            config.vector_way_quota=p->vector_way_quota;
+            config.prefetcher=p->prefetcher;
+            config.prefetch_degree=p->prefetch_degree;
+            config.initiation_interval=p->initiation_interval;
+            config.tag_latency=p->tag_latency;
+            config.data_latency=p->data_latency;
+            config.access_mode=p->access_mode;
+            config.write_combining_entries=p->write_combining_entries;
+            config.write_combining_window=p->write_combining_window;
+            config.way_partitioning=p->way_partitioning;
+            config.way_partition_masks=p->way_partition_masks;
+            config.way_partition_schedule=p->way_partition_schedule;
+            config.stack_distance_profiling=p->stack_distance_profiling;
+            config.stack_distance_sampling=p->stack_distance_sampling;
+            config.stack_distance_max_size_kb=p->stack_distance_max_size_kb;
+            config.stack_distance_max_associativity=p->stack_distance_max_associativity;
+            config.stack_distance_file_prefix=p->stack_distance_file_prefix;
+            return config;
+        }
+    }
+
     ////////////////////////////////////////////////////////////////////////////////
     // Constructor
     ////////////////////////////////////////////////////////////////////////////////
 
     L2CacheBank::L2CacheBank(sparta::TreeNode *node, const L2CacheBankParameterSet *p) :
-                    CacheBank(node, p->always_hit, p->writeback, p->miss_latency, p->hit_latency,
-                              p->max_outstanding_misses, p->max_outstanding_wbs, false, p->unit_test, p->line_size, p->size_kb,
-                              p->associativity, p->lvrf_ways, p->bank_and_tile_offset)
+                    CacheBank(node, getCacheBankConfig(p))
     {
         in_core_req_.registerConsumerHandler
                 (CREATE_SPARTA_HANDLER_WITH_DATA(L2CacheBank, getAccess_, std::shared_ptr<Request>));
@@ -129,9 +167,9 @@ namespace coyote
     
     
     // Reload cache line
-    void L2CacheBank::reloadCache_(uint64_t phyAddr, uint16_t bank, CacheRequest::AccessType type, bool is_vector)
+    void L2CacheBank::reloadCache_(uint64_t phyAddr, uint16_t bank, CacheRequest::AccessType type, bool is_vector, uint64_t pc, bool is_prefetch, uint16_t partition)
     {
-        CacheBank::reloadCache_(phyAddr, bank, type, is_vector);
+        CacheBank::reloadCache_(phyAddr, bank, type, is_vector, pc, is_prefetch, partition);
         
         auto l2_cache_line = &l2_cache_->getLineForReplacementWithInvalidCheck(phyAddr);
         if(trace_) {
@@ -90,8 +90,27 @@ namespace coyote
             // Parameters for event scheduling
             PARAMETER(uint16_t, miss_latency, 10, "Cache miss latency")
             PARAMETER(uint16_t, hit_latency, 10, "Cache hit latency")
+            PARAMETER(uint16_t, initiation_interval, 0, "Cycles between the start of two consecutive lookups (0 means hit_latency, i.e. not pipelined)")
+            PARAMETER(uint16_t, tag_latency, 0, "Latency of the tag array. If it or data_latency is not 0, they replace hit_latency")
+            PARAMETER(uint16_t, data_latency, 0, "Latency of the data array")
+            PARAMETER(std::string, access_mode, "serial", "How the tag and data arrays are accessed (serial, parallel)")
             PARAMETER(uint16_t, max_outstanding_misses, 8, "Maximum misses in flight to the next level")
             PARAMETER(uint16_t, max_outstanding_wbs, 1, "Maximum number of in flight wbs")
+            PARAMETER(std::string, replacement_policy, "tree_plru", "The replacement policy (tree_plru, srrip, brrip, drrip, ship)")
+            PARAMETER(std::string, vector_fill_policy, "normal", "How the lines brought by vector loads are inserted (normal, low_priority, reuse_predictor)")
+            PARAMETER(uint64_t, vector_way_quota, 0, "The maximum number of ways of a set that can hold lines brought by vector requests (0 means no limit)")
+            PARAMETER(std::string, prefetcher, "none", "The prefetcher attached to the bank (none, next_line, stride, stream)")
+            PARAMETER(uint16_t, prefetch_degree, 2, "The maximum number of lines prefetched for each access")
+            PARAMETER(uint16_t, write_combining_entries, 0, "Lines in the write-combining buffer for the stores of a write-through bank (0 disables it)")
+            PARAMETER(uint16_t, write_combining_window, 32, "Cycles a line stays in the write-combining buffer before it is written (0 means until it is evicted or flushed by a fence)")
+            PARAMETER(std::string, way_partitioning, "none", "How the ways are partitioned (none, core, tile)")
+            PARAMETER(std::vector<std::string>, way_partition_masks, std::vector<std::string>(), "The ways of each core or tile, as id:mask (the others use all the ways)")
+            PARAMETER(std::vector<std::string>, way_partition_schedule, std::vector<std::string>(), "Changes of the way partition masks, as cycle:id:mask")
+            PARAMETER(bool, stack_distance_profiling, false, "Write the miss ratio curves of LRU caches of every power-of-two size and associativity for the accesses to the bank")
+            PARAMETER(uint32_t, stack_distance_sampling, 32, "One out of every stack_distance_sampling sets is profiled (power of 2)")
+            PARAMETER(uint64_t, stack_distance_max_size_kb, 0, "The largest profiled size in KB (0 means 4 times size_kb)")
+            PARAMETER(uint64_t, stack_distance_max_associativity, 32, "The largest profiled associativity (power of 2)")
+            PARAMETER(std::string, stack_distance_file_prefix, "stack_distance_", "Prefix of the CSV file with the miss ratio curves of each bank")
             PARAMETER(bool, unit_test, false, "The bank will be used in a unit testing scenario")
         };
 
@@ -136,7 +155,7 @@ namespace coyote
         virtual bool handleCacheLookupReq_(const MemoryAccessInfoPtr & mem_access_info_ptr) override;
     private:
         Tile *tile;
-        virtual void reloadCache_(uint64_t, uint16_t, CacheRequest::AccessType, bool is_vector) override;
+        virtual void reloadCache_(uint64_t, uint16_t, CacheRequest::AccessType, bool is_vector, uint64_t pc, bool is_prefetch, uint16_t partition) override;
         virtual void logCacheRequest(std::shared_ptr<CacheRequest> r) override;
 
     };
@@ -26,14 +26,40 @@ namespace coyote
 {
     const char L3CacheBank::name[] = "l3";
 
+    namespace
+    {
+        CacheBank::Config getCacheBankConfig(const L3CacheBank::L3CacheBankParameterSet* p)
+        {
+            CacheBank::Config config;
+            config.always_hit=p->always_hit;
+            config.miss_latency=p->miss_latency;
+            config.hit_latency=p->hit_latency;
+            config.max_outstanding_misses=p->max_outstanding_misses;
+            config.max_in_flight_wbs=p->max_outstanding_wbs;
+            config.unit_test=p->unit_test;
+            config.line_size=p->line_size;
+            config.size_kb=p->size_kb;
+            config.associativity=p->associativity;
+            config.bank_and_tile_offset=p->bank_and_tile_offset;
+            config.replacement_policy=p->replacement_policy;
+            config.way_partitioning=p->way_partitioning;
+            config.way_partition_masks=p->way_partition_masks;
+            config.way_partition_schedule=p->way_partition_schedule;
+            config.stack_distance_profiling=p->stack_distance_profiling;
+            config.stack_distance_sampling=p->stack_distance_sampling;
+            config.stack_distance_max_size_kb=p->stack_distance_max_size_kb;
+            config.stack_distance_max_associativity=p->stack_distance_max_associativity;
+            config.stack_distance_file_prefix=p->stack_distance_file_prefix;
+            return config;
+        }
+    }
+
     ////////////////////////////////////////////////////////////////////////////////
     // Constructor
     ////////////////////////////////////////////////////////////////////////////////
 
     L3CacheBank::L3CacheBank(sparta::TreeNode *node, const L3CacheBankParameterSet *p) :
-                    CacheBank(node, p->always_hit, true, p->miss_latency, p->hit_latency,
-                              p->max_outstanding_misses, p->max_outstanding_wbs, false, p->unit_test, p->line_size, p->size_kb,
-                              p->associativity, 0, p->bank_and_tile_offset)
+                    CacheBank(node, getCacheBankConfig(p))
     {
         in_core_req_.registerConsumerHandler
                 (CREATE_SPARTA_HANDLER_WITH_DATA(L3CacheBank, getAccess_, std::shared_ptr<Request>));
@@ -89,6 +89,15 @@ namespace coyote
             PARAMETER(uint16_t, hit_latency, 10, "Cache hit latency")
             PARAMETER(uint16_t, max_outstanding_misses, 8, "Maximum misses in flight to the next level")
             PARAMETER(uint16_t, max_outstanding_wbs, 1, "Maximum number of in flight wbs")
+            PARAMETER(std::string, replacement_policy, "tree_plru", "The replacement policy (tree_plru, srrip, brrip, drrip, ship)")
+            PARAMETER(std::string, way_partitioning, "none", "How the ways are partitioned (none, core, tile)")
+            PARAMETER(std::vector<std::string>, way_partition_masks, std::vector<std::string>(), "The ways of each core or tile, as id:mask (the others use all the ways)")
+            PARAMETER(std::vector<std::string>, way_partition_schedule, std::vector<std::string>(), "Changes of the way partition masks, as cycle:id:mask")
+            PARAMETER(bool, stack_distance_profiling, false, "Write the miss ratio curves of LRU caches of every power-of-two size and associativity for the accesses to the bank")
+            PARAMETER(uint32_t, stack_distance_sampling, 32, "One out of every stack_distance_sampling sets is profiled (power of 2)")
+            PARAMETER(uint64_t, stack_distance_max_size_kb, 0, "The largest profiled size in KB (0 means 4 times size_kb)")
+            PARAMETER(uint64_t, stack_distance_max_associativity, 32, "The largest profiled associativity (power of 2)")
+            PARAMETER(std::string, stack_distance_file_prefix, "stack_distance_", "Prefix of the CSV file with the miss ratio curves of each bank")
             PARAMETER(bool, unit_test, false, "The bank will be used in a unit testing scenario")
         };
 
@@ -0,0 +1,100 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "MCPUPrefetcher.hpp"
+
+namespace coyote {
+
+	MCPUPrefetcher::MCPUPrefetcher(uint64_t line_size, uint16_t degree):
+		line_size(line_size),
+		degree(degree),
+		table(TABLE_SIZE),
+		recent_lines(RECENT_FILTER_SIZE, UINT64_MAX) {}
+
+	void MCPUPrefetcher::notifyInstruction(const std::shared_ptr<MCPUInstruction>& instr, uint32_t vvl, std::vector<uint64_t>& candidates) {
+		computeFootprint(instr, vvl);
+		for(uint64_t line : footprint) {
+			testAndSetRecent(line);	// Demanded lines must not be prefetched again
+		}
+
+		uint64_t base = instr->getAddress();
+		Entry& e = table[((instr->getPC() >> 1) ^ ((uint64_t)instr->getCoreId() << 4)) % TABLE_SIZE];
+		if(!e.valid || e.core != instr->getCoreId() || e.pc != instr->getPC()) {
+			e.core = instr->getCoreId();
+			e.pc = instr->getPC();
+			e.base = base;
+			e.delta = 0;
+			e.valid = true;
+			return;
+		}
+
+		int64_t delta = (int64_t)(base - e.base);
+		bool contiguous = instr->get_suboperation() == MCPUInstruction::SubOperation::UNIT &&
+						  delta == (int64_t)vvl * (int64_t)instr->get_width();
+		bool confirmed = delta != 0 && (delta == e.delta || contiguous);
+		e.base = base;
+		e.delta = delta;
+
+		if(!confirmed) {
+			return;
+		}
+
+		for(uint16_t k = 1; k <= degree; ++k) {
+			for(uint64_t line : footprint) {
+				uint64_t target = ((line + k*delta) / line_size) * line_size;
+				if(!testAndSetRecent(target)) {
+					candidates.push_back(target);
+				}
+			}
+		}
+	}
+
+	void MCPUPrefetcher::computeFootprint(const std::shared_ptr<MCPUInstruction>& instr, uint32_t vvl) {
+		footprint.clear();
+		uint64_t base = instr->getAddress();
+		uint64_t width = (uint64_t)instr->get_width();
+
+		if(instr->get_suboperation() == MCPUInstruction::SubOperation::UNIT) {
+			if(vvl == 0) {
+				return;
+			}
+			uint64_t last_line = (base + vvl*width - 1) / line_size;
+			for(uint64_t line = base / line_size; line <= last_line; ++line) {
+				footprint.push_back(line*line_size);
+			}
+		} else {
+			for(uint64_t index : instr->get_index()) {
+				uint64_t line = ((base + index) / line_size) * line_size;
+				if(footprint.empty() || footprint.back() != line) {	// Consecutive elements usually share the line
+					footprint.push_back(line);
+				}
+			}
+		}
+	}
+
+	bool MCPUPrefetcher::testAndSetRecent(uint64_t line_addr) {
+		uint64_t line = line_addr / line_size;
+		uint64_t& entry = recent_lines[(line ^ (line >> 9)) % RECENT_FILTER_SIZE];
+		if(entry == line_addr) {
+			return true;
+		}
+		entry = line_addr;
+		return false;
+	}
+}
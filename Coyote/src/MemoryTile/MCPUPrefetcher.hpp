@@ -0,0 +1,89 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __MCPU_PREFETCHER_HH__
+#define __MCPU_PREFETCHER_HH__
+
+#include <memory>
+#include <vector>
+#include "MCPUInstruction.hpp"
+
+namespace coyote {
+
+	class MCPUPrefetcher {
+		/*!
+		 * \class coyote::MCPUPrefetcher
+		 * \brief Descriptor-driven prefetcher for the vector memory instructions handled by the MCPU.
+		 * A direct-mapped table indexed by core and PC keeps the base address of the last instance of each
+		 * instruction and the delta between the base addresses of its last two instances. The footprint of the
+		 * next degree instances is predicted by shifting the lines touched by the current one (computed from its
+		 * base, stride or indices and VVL) by that delta. Unit-stride instructions whose base advances by exactly
+		 * their footprint are predicted from their second instance; the rest need the same delta twice in a row.
+		 */
+		public:
+
+			/*!
+			 * \brief Constructor for MCPUPrefetcher
+			 * \param line_size The size of a cache line in the LLC
+			 * \param degree The number of future instances of each instruction whose footprint is prefetched
+			 */
+			MCPUPrefetcher(uint64_t line_size, uint16_t degree);
+
+			/*!
+			 * \brief Observe a vector memory instruction that is about to be issued
+			 * \param instr The instruction
+			 * \param vvl The VVL of the instruction
+			 * \param candidates The addresses of the lines to prefetch are appended here
+			 */
+			void notifyInstruction(const std::shared_ptr<MCPUInstruction>& instr, uint32_t vvl, std::vector<uint64_t>& candidates);
+
+		private:
+			static constexpr uint16_t TABLE_SIZE=64;
+			static constexpr uint16_t RECENT_FILTER_SIZE=512;	// Lines recently requested, to avoid prefetching them twice
+
+			struct Entry {
+				uint16_t core=0;
+				uint64_t pc=0;
+				uint64_t base=0;
+				int64_t delta=0;
+				bool valid=false;
+			};
+
+			uint64_t line_size;
+			uint16_t degree;
+			std::vector<Entry> table;
+			std::vector<uint64_t> recent_lines;
+			std::vector<uint64_t> footprint;	// The lines touched by the current instruction
+
+			/*!
+			 * \brief Compute the lines touched by an instruction
+			 * \param instr The instruction
+			 * \param vvl The VVL of the instruction
+			 */
+			void computeFootprint(const std::shared_ptr<MCPUInstruction>& instr, uint32_t vvl);
+
+			/*!
+			 * \brief Check if a line has been recently requested and record it otherwise
+			 * \param line_addr The address of the line
+			 * \return True if the line was recently requested
+			 */
+			bool testAndSetRecent(uint64_t line_addr);
+	};
+}
+#endif
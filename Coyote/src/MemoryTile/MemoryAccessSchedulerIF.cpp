@@ -82,7 +82,7 @@ namespace coyote
             {
                 std::shared_ptr<CacheRequest> req=c->getRequest();
 
-                if((!write_allocate || c->getRequest()->getType()==CacheRequest::AccessType::WRITEBACK) && req->getSizeRequestedToMemory()>=req->getSize())
+                if((!write_allocate || c->getRequest()->getType()==CacheRequest::AccessType::WRITEBACK || req->isFullLineWrite()) && req->getSizeRequestedToMemory()>=req->getSize())
                 {
                     notifyRequestCompletion(req);
                     res=true;
@@ -122,7 +122,8 @@ namespace coyote
     {
         pending_command[c->getDestinationBank()]=false;
         std::shared_ptr<CacheRequest> req=c->getRequest();
-        if(req->getType()==CacheRequest::AccessType::STORE && write_allocate && req->getSizeRequestedToMemory()>=req->getSize() && !req->isAllocating())
+        //Full line writes do not need to read the line after writing it
+        if(req->getType()==CacheRequest::AccessType::STORE && write_allocate && !req->isFullLineWrite() && req->getSizeRequestedToMemory()>=req->getSize() && !req->isAllocating())
         {
             req->setAllocate();
         }
@@ -46,6 +46,8 @@ namespace coyote {
 			latency(p->latency),
 			llc_banks(p->num_llc_banks),
 			max_vvl(p->max_vvl),
+			prefetch_max_mc_occupancy(p->llc_prefetch_max_mc_occupancy),
+			mc_occupancy(0),
 			out_ports_llc(llc_banks),
 			in_ports_llc(llc_banks),
 			out_ports_llc_mc(llc_banks),
@@ -91,6 +93,11 @@ namespace coyote {
 				    printf("Unsupported cache data mapping policy\n");
 				}
 
+				//-- Prefetches are brought to the LLC, so it has to be enabled
+				if(p->llc_prefetch && enabled_llc) {
+					llc_prefetcher = std::make_unique<MCPUPrefetcher>(line_size, p->llc_prefetch_degree);
+				}
+
 				instructionID_counter = 1;
 				this->id = 0;
 								
@@ -407,6 +414,7 @@ namespace coyote {
 			}
 			DEBUG_MSG("Sending to MC: " << *instr_for_mc);
 			count_requests_mc++;
+			mc_occupancy++;
 		}
 		
 		//-- consume the memory request from the scheduler
@@ -477,6 +485,17 @@ namespace coyote {
 			DEBUG_MSG("VVL: " << local_vvl << ", elements/request: " << number_of_elements_per_request << ", remaining elements: " << remaining_elements << ", CR: " << *memory_request);
 			//memory_request->set_mem_op_latency(line_size/32);	// load 64 Bytes
             memory_request->setSize(line_size);
+			
+			//-- A store that covers a whole aligned line does not need the line to be read first
+			if(instr->get_operation() == MCPUInstruction::Operation::STORE) {
+				uint64_t remaining_bytes = (uint64_t)remaining_elements * (uint32_t)instr->get_width();
+				if(remaining_bytes < line_size) {
+					memory_request->setSize(remaining_bytes);
+				} else if(address % line_size == 0) {
+					memory_request->setFullLineWrite();
+					count_full_line_stores++;
+				}
+			}
 									
 			//-- schedule this request for the MC
 			sendToDestination(memory_request);
@@ -489,6 +508,8 @@ namespace coyote {
 		transaction_id->second.counter_cacheRequests = number_of_replies;		// How many responses are expected from the MC?
 		transaction_id->second.counter_scratchpadRequests = number_of_replies;	// How many responses are sent back to the VAS Tile?
 		transaction_id->second.number_of_elements_per_response = 1; 			// Send out every received CacheRequest from the MC (no parasitic bytes)
+		
+		issueLLCPrefetches(instr, local_vvl);
 	}
 	
 	void MemoryCPUWrapper::memOp_nonUnit(std::shared_ptr<MCPUInstruction> instr) {
@@ -514,6 +535,46 @@ namespace coyote {
 		transaction_id->second.number_of_elements_per_response = number_of_elements_per_response; 		// How many elements fit into 1 line_size (64 Bytes)?
 	
 		DEBUG_MSG("summary: expected CRs: " << local_vvl << ", SPs to return: " << transaction_id->second.counter_scratchpadRequests << ", elements per MC response: " << number_of_elements_per_response);	
+		
+		issueLLCPrefetches(instr, local_vvl);
+	}
+	
+	void MemoryCPUWrapper::issueLLCPrefetches(std::shared_ptr<MCPUInstruction> instr, uint32_t local_vvl) {
+		if(llc_prefetcher == nullptr || instr->get_operation() != MCPUInstruction::Operation::LOAD) {
+			return;
+		}
+		
+		prefetch_candidates.clear();
+		llc_prefetcher->notifyInstruction(instr, local_vvl, prefetch_candidates);
+		
+		uint32_t issued = 0;
+		for(uint64_t address : prefetch_candidates) {
+			if(calcDestMemTile(address) != getID()) {
+				count_llc_prefetches_remote++;
+				continue;
+			}
+			
+			//-- Most prefetches miss in the LLC, so the ones issued now are accounted as future MC requests
+			if(mc_occupancy + issued >= prefetch_max_mc_occupancy) {
+				count_llc_prefetches_throttled++;
+				continue;
+			}
+			
+			std::shared_ptr<CacheRequest> prefetch = std::make_shared<CacheRequest>(
+						address,
+						CacheRequest::AccessType::LOAD,
+						instr->getPC(),
+						getClock()->currentCycle(),
+						instr->getCoreId());
+			prefetch->setSize(line_size);
+			prefetch->setPrefetch(getContainer());
+			DEBUG_MSG("LLC prefetch: " << *prefetch);
+			
+			sched_mem_req.push(prefetch);
+			log_sched_mem_req();
+			issued++;
+			count_llc_prefetches++;
+		}
 	}
 	
 	void MemoryCPUWrapper::memOp_orderedIndex(std::shared_ptr<MCPUInstruction> instr) {
@@ -533,6 +594,9 @@ namespace coyote {
 	/////////////////////////////////////////////////////////////////////////////////////////////////
 	void MemoryCPUWrapper::receiveMessage_mc(const std::shared_ptr<CacheRequest> &mes)	{
 
+		mes->setServiceLevel(ServiceLevel::MEMORY);
+		mc_occupancy--;
+
 		if(this->enabled_llc) {
 			out_ports_llc_mc[calculateBank(mes)]->send(mes, 0);
 			
@@ -601,6 +665,16 @@ namespace coyote {
 	//-- Message Handling from the LLC
 	/////////////////////////////////////////////////////////////////////////////////////////////////
 	void MemoryCPUWrapper::receiveMessage_llc(const std::shared_ptr<CacheRequest> &mes) {
+		//-- The LLC prefetches of this MCPU only fill the LLC, nobody waits for them.
+		//-- Replies to the prefetches of the L2 banks go back to their tile
+		if(mes->isPrefetchIssuedBy(getContainer())) {
+			return;
+		}
+		
+		//-- Requests that went through the MC keep the MEMORY level
+		if(mes->getServiceLevel() != ServiceLevel::MEMORY) {
+			mes->setServiceLevel(ServiceLevel::LLC);
+		}
 		sched_incoming_mc.push(mes);
 		if(trace_) {
 			logger_->logMemTileLLCRecv(getClock()->currentCycle(), getID(), mes->getAddress(), getParentAddress(mes));
@@ -611,6 +685,7 @@ namespace coyote {
 	void MemoryCPUWrapper::receiveMessage_llc_mc(const std::shared_ptr<CacheRequest> &mes) {
 		out_port_mc.send(mes, 0);
 		count_requests_mc++;
+		mc_occupancy++;
 		
 		if(trace_) {
 			logger_->logMemTileLLC2MC(getClock()->currentCycle(), getID(), mes->getAddress(), getParentAddress(mes));
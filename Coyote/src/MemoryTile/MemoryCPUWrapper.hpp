@@ -38,6 +38,7 @@
 #include "CacheRequest.hpp"
 #include "ScratchpadRequest.hpp"
 #include "CacheDataMappingPolicy.hpp"
+#include "MCPUPrefetcher.hpp"
 #include "Bus.hpp"
 #include <unordered_map>
 
@@ -66,6 +67,9 @@ namespace coyote {
 					PARAMETER(uint32_t, max_vvl, 65536, "The maximum vvl that the MCPU will return")
 					PARAMETER(bool, enable_smart_mcpu, false, "Enable the Memory Tile/MCPU")
 					PARAMETER(bool, enable_llc, true, "Enable the LLC/L3")
+					PARAMETER(bool, llc_prefetch, false, "Prefetch into the LLC the footprint predicted for the next instances of the vector loads")
+					PARAMETER(uint16_t, llc_prefetch_degree, 1, "The number of future instances of each vector load whose footprint is prefetched")
+					PARAMETER(uint32_t, llc_prefetch_max_mc_occupancy, 16, "Prefetches are only issued while fewer requests than this are in flight to the MC")
 			};
 
 			/*!
@@ -163,6 +167,11 @@ namespace coyote {
 
 			uint64_t mc_shift;
 			uint64_t mc_mask;
+
+			std::unique_ptr<MCPUPrefetcher> llc_prefetcher;	// nullptr if LLC prefetching is disabled
+			uint32_t prefetch_max_mc_occupancy;
+			uint32_t mc_occupancy;	// requests sent to the MC that have not been answered yet
+			std::vector<uint64_t> prefetch_candidates;
 			
 			uint8_t tag_bits;
 			uint8_t block_offset_bits;
@@ -261,6 +270,14 @@ namespace coyote {
 			void memOp_orderedIndex(std::shared_ptr<MCPUInstruction> instr);
 			void memOp_unorderedIndex(std::shared_ptr<MCPUInstruction> instr);
 
+			/*!
+			 * \brief Prefetch into the LLC the lines that the next instances of a vector load are predicted to access.
+			 * Only lines served by this memory tile are prefetched, and only while the MC occupancy is below the threshold.
+			 * \param instr The vector load
+			 * \param local_vvl The VVL of the vector load
+			 */
+			void issueLLCPrefetches(std::shared_ptr<MCPUInstruction> instr, uint32_t local_vvl);
+
 			//This two functions might be fused into one with a better class hierarchy
 			std::shared_ptr<ScratchpadRequest> createScratchpadRequest(const std::shared_ptr<Request> &mes, ScratchpadRequest::ScratchpadCommand command);
 			std::shared_ptr<ScratchpadRequest> createScratchpadRequest(const std::shared_ptr<MCPUInstruction> &mes, ScratchpadRequest::ScratchpadCommand command);
@@ -354,6 +371,34 @@ namespace coyote {
 					"Number of requests to the LLC",
 					sparta::Counter::COUNT_NORMAL
 			);
+			
+			sparta::Counter count_full_line_stores			= sparta::Counter(
+					getStatisticSet(),
+					"full_line_stores",
+					"Number of requests of vector stores that overwrite a whole line",
+					sparta::Counter::COUNT_NORMAL
+			);
+			
+			sparta::Counter count_llc_prefetches			= sparta::Counter(
+					getStatisticSet(),
+					"llc_prefetches",
+					"Number of prefetches issued to the LLC",
+					sparta::Counter::COUNT_NORMAL
+			);
+			
+			sparta::Counter count_llc_prefetches_throttled	= sparta::Counter(
+					getStatisticSet(),
+					"llc_prefetches_throttled",
+					"Number of prefetches dropped because of the occupancy of the MC",
+					sparta::Counter::COUNT_NORMAL
+			);
+			
+			sparta::Counter count_llc_prefetches_remote		= sparta::Counter(
+					getStatisticSet(),
+					"llc_prefetches_remote",
+					"Number of prefetches dropped because the line is served by another memory tile",
+					sparta::Counter::COUNT_NORMAL
+			);
 	};
 }
 #endif
@@ -0,0 +1,35 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "NextLinePrefetcher.hpp"
+
+namespace coyote
+{
+    NextLinePrefetcher::NextLinePrefetcher(uint64_t line_stride, uint16_t degree) :
+        PrefetcherIF(line_stride, degree)
+    {}
+
+    void NextLinePrefetcher::notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates)
+    {
+        if(miss || prefetch_hit)
+        {
+            appendLines(line_addr, 1, candidates);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#ifndef __NEXT_LINE_PREFETCHER_HH__
+#define __NEXT_LINE_PREFETCHER_HH__
+
+#include "PrefetcherIF.hpp"
+
+namespace coyote
+{
+    class NextLinePrefetcher : public PrefetcherIF
+    {
+        /*!
+         * \class coyote::NextLinePrefetcher
+         * \brief Tagged next-line prefetcher. Misses and the first hits on prefetched lines
+         * trigger the prefetch of the next degree lines of the bank.
+         */
+        public:
+
+            /*!
+            * \brief Constructor for NextLinePrefetcher
+            * \param line_stride The distance in bytes between two consecutive lines mapped to the bank
+            * \param degree The number of lines prefetched on each trigger
+            */
+            NextLinePrefetcher(uint64_t line_stride, uint16_t degree);
+
+            /*!
+            * \brief Observe a demand access to the bank
+            * \param line_addr The address of the accessed line
+            * \param pc The PC of the instruction that made the access
+            * \param miss True if the access missed in the bank
+            * \param prefetch_hit True if the access is the first one to hit on a prefetched line
+            * \param candidates The addresses of the lines to prefetch are appended here
+            */
+            void notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates) override;
+    };
+}
+#endif
@@ -0,0 +1,260 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "AnalyticalNoC.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+#define DESTINATION_ROUTER 1
+#define INJECTION 1
+#define LINK_TRAVERSAL 1
+
+using std::vector;
+
+namespace coyote
+{
+    AnalyticalNoC::AnalyticalNoC(sparta::TreeNode *node, const AnalyticalNoCParameterSet *params) :
+        NoC(node, params),
+        latency_per_hop_(params->latency_per_hop),
+        network_width_(params->network_width),
+        utilization_window_(params->utilization_window),
+        max_link_utilization_(params->max_link_utilization),
+        links_(noc_networks_.size() * size_ * NUM_PORTS),
+        injection_free_cycle_(noc_networks_.size() * size_, 0)
+    {
+        sparta_assert(noc_model_ == "analytical");
+        sparta_assert(params->network_width.isVector(), "The top.cpu.noc.params.network_width must be a vector");
+        sparta_assert(params->network_width.getNumValues() == noc_networks_.size(),
+            "The number of elements in top.cpu.noc.params.network_width must be: " << noc_networks_.size());
+        sparta_assert(utilization_window_ > 0, "The utilization_window must be greater than 0");
+        sparta_assert(max_link_utilization_ >= 0 && max_link_utilization_ < 1, "The max_link_utilization must be in [0, 1)");
+
+        // Tiles are placed in order in the positions of the mesh that are not used by MCPUs
+        uint16_t mcpu = 0;
+        for(uint16_t idx = 0; idx < size_; idx++)
+        {
+            if(mcpu < mcpus_indices_.size() && mcpus_indices_.at(mcpu) == idx)
+            {
+                mcpu_to_node_.push_back(idx);
+                mcpu++;
+            }
+            else
+                tile_to_node_.push_back(idx);
+        }
+        sparta_assert(mcpu_to_node_.size() == num_memory_cpus_);
+        sparta_assert(tile_to_node_.size() == num_tiles_);
+        enableLinkStatistics_({x_size_, y_size_}, false);
+
+        // Statistics
+        for(auto network : noc_networks_)
+        {
+            hop_count_.push_back(sparta::Counter(
+                getStatisticSet(),                                       // parent
+                "hop_count_" + network,                                  // name
+                "Total number of packet hops in " + network + " NoC",    // description
+                sparta::Counter::COUNT_NORMAL                            // behavior
+            ));
+            packet_latency_.push_back(sparta::Counter(
+                getStatisticSet(),                                       // parent
+                "packet_latency_" + network,                             // name
+                "Accumulated packet latency in " + network + " NoC",     // description
+                sparta::Counter::COUNT_NORMAL                            // behavior
+            ));
+            queueing_delay_.push_back(sparta::Counter(
+                getStatisticSet(),                                       // parent
+                "queueing_delay_" + network,                             // name
+                "Accumulated queueing delay in the links of " + network + " NoC", // description
+                sparta::Counter::COUNT_NORMAL                            // behavior
+            ));
+            injection_delay_.push_back(sparta::Counter(
+                getStatisticSet(),                                       // parent
+                "injection_delay_" + network,                            // name
+                "Accumulated delay waiting for the injection channel in " + network + " NoC", // description
+                sparta::Counter::COUNT_NORMAL                            // behavior
+            ));
+
+            average_hop_count_.push_back(sparta::StatisticDef(
+                getStatisticSet(),                                      // parent
+                "average_hop_count_" + network,                         // name
+                "Average hop count in  " + network + " NoC",            // description
+                getStatisticSet(),                                      // context
+                "hop_count_" + network + "/sent_packets_"+network       // Expression
+            ));
+            avg_packet_lat_.push_back(sparta::StatisticDef(
+                getStatisticSet(),                                      // parent
+                "avg_pkt_latency_" + network,                           // name
+                "Avg. Packet Latency in " + network + " NoC",           // description
+                getStatisticSet(),                                      // context
+                "packet_latency_" + network + "/sent_packets_" + network // Expression
+            ));
+            avg_queueing_delay_.push_back(sparta::StatisticDef(
+                getStatisticSet(),                                      // parent
+                "avg_queueing_delay_" + network,                        // name
+                "Avg. queueing delay in the links of " + network + " NoC", // description
+                getStatisticSet(),                                      // context
+                "queueing_delay_" + network + "/sent_packets_" + network // Expression
+            ));
+        }
+    }
+
+    bool AnalyticalNoC::checkSpaceForPacket(const bool injectedByTile, const std::shared_ptr<NoCMessage> & mess){return true;}
+
+    void AnalyticalNoC::handleMessageFromTile_(const std::shared_ptr<NoCMessage> & mess)
+    {
+        // Call to parent class to fill base statistics
+        NoC::handleMessageFromTile_(mess);
+        switch(mess->getType())
+        {
+            // VAS -> VAS messages
+            case NoCMessageType::REMOTE_L2_REQUEST:
+            case NoCMessageType::REMOTE_L2_ACK:
+            case NoCMessageType::COHERENCE_REQUEST:
+            case NoCMessageType::COHERENCE_INVALIDATE:
+            case NoCMessageType::COHERENCE_FORWARD:
+            case NoCMessageType::COHERENCE_ACK:
+                forwardPacket_(mess, tile_to_node_[mess->getSrcPort()], tile_to_node_[mess->getDstPort()], false);
+                break;
+
+            // VAS -> MEM messages
+            case NoCMessageType::MEMORY_REQUEST_LOAD:
+            case NoCMessageType::MEMORY_REQUEST_STORE:
+            case NoCMessageType::MEMORY_REQUEST_WB:
+            case NoCMessageType::MCPU_REQUEST:
+            case NoCMessageType::SCRATCHPAD_ACK:
+            case NoCMessageType::SCRATCHPAD_DATA_REPLY:
+                forwardPacket_(mess, tile_to_node_[mess->getSrcPort()], mcpu_to_node_[mess->getDstPort()], true);
+                break;
+
+            default:
+                sparta_assert(false);
+        }
+    }
+
+    void AnalyticalNoC::handleMessageFromMemoryCPU_(const std::shared_ptr<NoCMessage> & mess)
+    {
+        // Call to parent class to fill base statistics
+        NoC::handleMessageFromMemoryCPU_(mess);
+        switch(mess->getType())
+        {
+            // MEM -> VAS messages
+            case NoCMessageType::MEMORY_ACK:
+            case NoCMessageType::MCPU_REQUEST:
+            case NoCMessageType::SCRATCHPAD_COMMAND:
+                forwardPacket_(mess, mcpu_to_node_[mess->getSrcPort()], tile_to_node_[mess->getDstPort()], false);
+                break;
+
+            // MEM -> MEM messages
+            case NoCMessageType::MEM_TILE_REQUEST:
+            case NoCMessageType::MEM_TILE_REPLY:
+                forwardPacket_(mess, mcpu_to_node_[mess->getSrcPort()], mcpu_to_node_[mess->getDstPort()], true);
+                break;
+
+            default:
+                sparta_assert(false);
+        }
+    }
+
+    void AnalyticalNoC::forwardPacket_(const std::shared_ptr<NoCMessage> & mess, uint16_t src, uint16_t dst, bool to_memory_cpu)
+    {
+        uint8_t network = mess->getNoCNetwork();
+        uint64_t current_cycle = getClock()->currentCycle();
+        uint16_t flits = (uint16_t) ceil(1.0*mess->getSize()/network_width_[network]); // message size and network_width are in bits
+        sparta_assert(flits >= 1);
+
+        // The injection channel serializes the flits of the packets injected by the same node
+        uint64_t& injection_free_cycle = injection_free_cycle_[network * size_ + src];
+        uint64_t injection_cycle = std::max(current_cycle, injection_free_cycle);
+        injection_free_cycle = injection_cycle + flits;
+
+        // DOR-XY route: first along X and then along Y, accumulating the queueing delay of each output link
+        double queueing_delay = 0;
+        int x = src % x_size_;
+        int y = src / x_size_;
+        const int dst_x = dst % x_size_;
+        const int dst_y = dst / x_size_;
+        int hop_count = abs(dst_x - x) + abs(dst_y - y) + DESTINATION_ROUTER;
+        while(x != dst_x)
+        {
+            queueing_delay += traverseLink_(network, y * x_size_ + x, dst_x > x ? EAST : WEST, flits);
+            x += dst_x > x ? 1 : -1;
+        }
+        while(y != dst_y)
+        {
+            queueing_delay += traverseLink_(network, y * x_size_ + x, dst_y > y ? SOUTH : NORTH, flits);
+            y += dst_y > y ? 1 : -1;
+        }
+        queueing_delay += traverseLink_(network, dst, EJECTION, flits);
+        sparta_assert(hop_count >= 0 && hop_count <= x_size_ + y_size_ - 1);
+
+        // Latency: Injection + Link traversal + hops * latency_per_hop (RC - VA - SA - ST + output_link) + contention + serialization of the tail flits
+        uint64_t link_contention = std::llround(queueing_delay);
+        uint64_t contention = (injection_cycle - current_cycle) + link_contention;
+        uint64_t latency = INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_ + contention + (flits - 1);
+        delivery_queue_.push(network, to_memory_cpu, mess->getDstPort(), mess, current_cycle + latency);
+
+        hop_count_[network] += hop_count;
+        packet_latency_[network] += latency;
+        queueing_delay_[network] += link_contention;
+        injection_delay_[network] += injection_cycle - current_cycle;
+        if(link_stats_)
+        {
+            link_stats_->addPacket(network, src, dst, flits, current_cycle);
+            link_stats_->addRouterOccupancy(network, src, dst, flits * (hop_count * latency_per_hop_ + queueing_delay), current_cycle);
+        }
+    }
+
+    double AnalyticalNoC::traverseLink_(uint8_t network, uint16_t node, uint8_t port, uint16_t flits)
+    {
+        Link& link = links_[(network * size_ + node) * NUM_PORTS + port];
+        uint64_t current_cycle = getClock()->currentCycle();
+        uint64_t window = current_cycle / utilization_window_;
+        if(link.window != window)
+        {
+            // Slide the window. The counts are dropped if the link has not been used for a whole window
+            bool consecutive = link.window + 1 == window;
+            link.previous_flits = consecutive ? link.flits : 0;
+            link.previous_packets = consecutive ? link.packets : 0;
+            link.flits = 0;
+            link.packets = 0;
+            link.window = window;
+        }
+
+        // The traffic in the last utilization_window cycles, weighting the previous window by the part of it still inside
+        double previous_weight = 1.0 - 1.0 * (current_cycle % utilization_window_) / utilization_window_;
+        double recent_flits = link.flits + previous_weight * link.previous_flits;
+        double recent_packets = link.packets + previous_weight * link.previous_packets;
+
+        double queueing_delay = 0;
+        if(recent_packets > 0)
+        {
+            // M/D/1: Wq = rho * S / (2 * (1 - rho)), with S the average service time (packet size in flits) of the link
+            double utilization = std::min(recent_flits / utilization_window_, max_link_utilization_);
+            double service_time = recent_flits / recent_packets;
+            queueing_delay = utilization * service_time / (2 * (1 - utilization));
+        }
+
+        link.flits += flits;
+        link.packets++;
+        return queueing_delay;
+    }
+
+} // coyote
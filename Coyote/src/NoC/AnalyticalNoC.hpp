@@ -0,0 +1,154 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __ANALYTICAL_NOC_H__
+#define __ANALYTICAL_NOC_H__
+
+#include "NoC.hpp"
+
+using std::vector;
+using std::string;
+
+namespace coyote
+{
+    class AnalyticalNoC : public NoC
+    {
+        /*!
+         * \class AnalyticalNoC
+         * \brief Analytical model of a mesh NoC that estimates the contention of each packet from the recent utilization of the links in its route
+         * 
+         * It models a MESH with DOR-XY routing. Each packet is serialized in the injection channel of its source depending on its
+         * size in flits and the width of its network. Each link in its route adds the queueing delay of an M/D/1 queue with the
+         * utilization of the link in the last utilization_window cycles. It is more accurate than the simple model under load and
+         * much faster than the detailed model.
+         */
+    public:
+        /*!
+         * \class AnalyticalNoCParameterSet
+         * \brief Parameters for analytical NoC
+         */
+        class AnalyticalNoCParameterSet : public NoCParameterSet
+        {
+        public:
+            //! Constructor for AnalyticalNoCParameterSet
+            AnalyticalNoCParameterSet(sparta::TreeNode* node) :
+                NoCParameterSet(node)
+            {
+            }
+            PARAMETER(uint16_t, latency_per_hop, 4, "The latency for each hop without contention (router + output_link)")
+            PARAMETER(uint32_t, utilization_window, 1000, "The number of cycles over which the utilization of each link is measured")
+            PARAMETER(double, max_link_utilization, 0.95, "The maximum utilization of a link used to estimate its queueing delay")
+        };
+
+        /*!
+         * \brief Constructor for AnalyticalNoC
+         * \param node The node that represent the NoC and
+         * \param params The AnalyticalNoC parameter set
+         */
+        AnalyticalNoC(sparta::TreeNode* node, const AnalyticalNoCParameterSet* params);
+
+        ~AnalyticalNoC() {
+            debug_logger_ << getContainer()->getLocation()
+                          << ": "
+                          << std::endl;
+        }
+
+        /*!
+         * \brief Check the injection queue space in NoC for a packet
+         * \param injectedByTile Indicates that the source of the messages is a VAS tile
+         * \param mess The packet
+         * \return If there is space for the packet on its corresponding injection queue
+         */
+        virtual bool checkSpaceForPacket(const bool injectedByTile, const std::shared_ptr<NoCMessage> & mess) override;
+
+        /*! \brief Forwards a message from TILE to the actual destination with the estimated latency of its route
+         *  \param mess The message to handle
+         */
+        void handleMessageFromTile_(const std::shared_ptr<NoCMessage> & mess) override;
+
+    private:
+
+        /*! \brief Forwards a message from a MCPU to the actual destination with the estimated latency of its route
+         *  \param mess The message to handle
+         */
+        void handleMessageFromMemoryCPU_(const std::shared_ptr<NoCMessage> & mess) override;
+
+        /*!
+         * \brief Estimate the latency of a packet, account its flits in the links of its route and queue it for delivery
+         * \param mess The message
+         * \param src The position in the mesh of the source
+         * \param dst The position in the mesh of the destination
+         * \param to_memory_cpu Whether the destination is a memory CPU or a tile
+         */
+        void forwardPacket_(const std::shared_ptr<NoCMessage> & mess, uint16_t src, uint16_t dst, bool to_memory_cpu);
+
+        /*!
+         * \brief Estimate the queueing delay in a link with an M/D/1 model and account the flits of a packet that traverses it
+         * \param network The network
+         * \param node The position in the mesh of the router the link goes out from
+         * \param port The output port of the router
+         * \param flits The size of the packet in flits
+         * \return The queueing delay in cycles
+         */
+        double traverseLink_(uint8_t network, uint16_t node, uint8_t port, uint16_t flits);
+
+        //! The output ports of a router
+        enum Port : uint8_t
+        {
+            EAST,
+            WEST,
+            NORTH,
+            SOUTH,
+            EJECTION,
+            NUM_PORTS
+        };
+
+        /*!
+         * \struct Link
+         * \brief The flits and packets that have traversed a link in the current and previous utilization windows
+         */
+        struct Link
+        {
+            uint64_t window=0;
+            uint32_t flits=0;
+            uint32_t packets=0;
+            uint32_t previous_flits=0;
+            uint32_t previous_packets=0;
+        };
+
+        uint16_t                            latency_per_hop_;       //! The latency for each hop without contention
+        vector<uint16_t>                    network_width_;         //! Physical channel width (bits)
+        uint32_t                            utilization_window_;    //! The number of cycles of a utilization window
+        double                              max_link_utilization_;  //! The maximum utilization used to estimate queueing delays
+        vector<uint16_t>                    tile_to_node_;          //! The positions in the mesh of the tiles
+        vector<uint16_t>                    mcpu_to_node_;          //! The positions in the mesh of the MCPUs
+        vector<Link>                        links_;                 //! The links indexed by network, router and output port
+        vector<uint64_t>                    injection_free_cycle_;  //! The cycle in which each injection channel is free, indexed by network and node
+        std::vector<sparta::Counter>        hop_count_;             //! Tracks the hop count for each NoC network
+        std::vector<sparta::Counter>        packet_latency_;        //! The accumulated packet latency in each NoC
+        std::vector<sparta::Counter>        queueing_delay_;        //! The accumulated queueing delay in the links of each NoC
+        std::vector<sparta::Counter>        injection_delay_;       //! The accumulated delay waiting for the injection channel in each NoC
+        std::vector<sparta::StatisticDef>   average_hop_count_;     //! The average hop count for each NoC (counts crossed routers)
+        std::vector<sparta::StatisticDef>   avg_packet_lat_;        //! Average packet latency in each NoC
+        std::vector<sparta::StatisticDef>   avg_queueing_delay_;    //! Average queueing delay in each NoC
+    };
+
+} // coyote
+
+#endif // __ANALYTICAL_NOC_H__
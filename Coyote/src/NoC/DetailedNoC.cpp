@@ -19,6 +19,8 @@
 
 #include <fstream>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include "DetailedNoC.hpp"
 #include "MemoryTile/MemoryCPUWrapper.hpp"
 #include "NoCMessage.hpp"
@@ -38,7 +40,9 @@ namespace coyote
         booksim_configuration_(params->booksim_configuration),
         network_width_(params->network_width),
         stats_files_prefix_(params->stats_files_prefix),
-        pkts_map_(vector(noc_networks_.size(), map<long,shared_ptr<NoCMessage>>()))
+        in_flight_pkts_(),
+        network_idle_(noc_networks_.size(), true),
+        pending_idle_cycles_(noc_networks_.size(), 0)
     {
         sparta_assert(noc_model_ == "detailed");
         sparta_assert(params->network_width.isVector(), "The top.cpu.noc.params.network_width must be a vector");
@@ -58,11 +62,13 @@ namespace coyote
         booksim_config.ParseFile(booksim_configuration_);
         ejection_queue_size_ = booksim_config.GetInt("ejection_queue_size");
         const string topology = booksim_config.GetStr("topology");
+        vector<uint16_t> dimensions; // The number of routers in each dimension, for the link statistics
         if(topology == "mesh") // Implemented as kncube network in BookSim
         {
             int n = booksim_config.GetInt("n");
             int k = booksim_config.GetInt("k");
             sparta_assert(size_ == pow(k, n), "The network size must be the same in BookSim and in Coyote");
+            dimensions.assign(n, k);
         } 
         else if(topology == "cmesh") // Implemented as ckncube network in BookSim
         {
@@ -73,11 +79,20 @@ namespace coyote
             for(int dim=0; dim < n; ++dim){
                 sparta_assert(c[dim] == 1, "The concentration must be equal to 1");
                 booksim_size *= k[dim];
+                dimensions.push_back(k[dim]);
             }
             sparta_assert(size_ == booksim_size, "The network size must be the same in BookSim and in Coyote");
         }
+        else if(topology == "torus") // Implemented as kncube network with wraparound links in BookSim. A ring is a torus with n = 1
+        {
+            int n = booksim_config.GetInt("n");
+            int k = booksim_config.GetInt("k");
+            sparta_assert(size_ == pow(k, n), "The network size must be the same in BookSim and in Coyote");
+            dimensions.assign(n, k);
+        }
         else
-            sparta_assert(false, "The supported networks are: mesh and cmesh");
+            sparta_assert(false, "The supported networks are: mesh, cmesh and torus");
+        enableLinkStatistics_(dimensions, topology == "torus");
         // Classes checks
         const uint8_t classes = booksim_config.GetInt("classes");
         uint8_t priorities = max_class_used_ + 1; // The number of priorities are: 0 .. max_class_used_
@@ -109,6 +124,10 @@ namespace coyote
         {
             min_space_in_inj_queue_[network_id] = booksim_config.GetInt("injection_queue_size");
         }
+        // Size the in-flight packet tables to hold the packets that fit in the injection and ejection queues of every node.
+        // A packet has at least one flit. If more packets are in flight, the tables grow
+        size_t packets_per_node = booksim_config.GetInt("injection_queue_size") * classes + ejection_queue_size_;
+        in_flight_pkts_.assign(noc_networks_.size(), InFlightPacketTable(size_ * packets_per_node));
         // Fill the mcpu_ and tile_to_network and network_is_mcpu vectors
         uint16_t mcpu = 0;
         uint16_t tile = 0;
@@ -169,6 +188,12 @@ namespace coyote
                 "Accumulated network latency in " + network + " NoC",    // description
                 sparta::Counter::COUNT_NORMAL                            // behavior
             ));
+            skipped_cycles_by_noc.push_back(sparta::Counter(
+                getStatisticSet(),                                       // parent
+                "skipped_cycles_" + network,                             // name
+                "Cycles in which " + network + " NoC was idle and BookSim was not executed", // description
+                sparta::Counter::COUNT_NORMAL                            // behavior
+            ));
 
             average_hop_count_by_noc.push_back(sparta::StatisticDef(
                 getStatisticSet(),                                      // parent
@@ -236,6 +261,7 @@ namespace coyote
         std::ofstream booksim_stats;
         for(uint8_t n=0; n < noc_networks_.size(); ++n)
         {
+            catchUpIdleNetwork_(n);
             string filename = stats_files_prefix_;
             filename += "_";
             filename += noc_networks_[n];
@@ -244,7 +270,7 @@ namespace coyote
             booksim_wrappers_[n]->PrintStats(booksim_stats);
             booksim_stats.close();
             // Check a missed in-flight packet
-            sparta_assert(pkts_map_[n].size() == 0);
+            sparta_assert(in_flight_pkts_[n].size() == 0);
         }
 
         // Delete BookSim wrappers
@@ -284,15 +310,24 @@ namespace coyote
         int size = (int) ceil(1.0*mess->getSize()/network_width_[mess->getNoCNetwork()]); // message size and network_width are in bits
         sparta_assert(checkSpaceForPacket(INJECTED_BY_TILE, mess), "Insufficient space at injection queue, please ask before inject or review injection_queue_size parameter");
         sparta_assert(size <= ejection_queue_size_, "Packet size is bigger than output queue size, please review the ejection_queue_size parameter.");
+        catchUpIdleNetwork_(mess->getNoCNetwork());
         long packet_id = INVALID_PKT_ID;
+        uint16_t src_node = 0;
+        uint16_t dst_node = 0;
         switch(mess->getType())
         {
             // VAS -> VAS messages
             case NoCMessageType::REMOTE_L2_REQUEST:
             case NoCMessageType::REMOTE_L2_ACK:
+            case NoCMessageType::COHERENCE_REQUEST:
+            case NoCMessageType::COHERENCE_INVALIDATE:
+            case NoCMessageType::COHERENCE_FORWARD:
+            case NoCMessageType::COHERENCE_ACK:
+                src_node = tile_to_network_[mess->getSrcPort()];
+                dst_node = tile_to_network_[mess->getDstPort()];
                 packet_id = booksim_wrappers_[mess->getNoCNetwork()]->GeneratePacket(
-                    tile_to_network_[mess->getSrcPort()],   // Source
-                    tile_to_network_[mess->getDstPort()],   // Destination
+                    src_node,                               // Source
+                    dst_node,                               // Destination
                     size,                                   // Number of flits
                     mess->getClass(),                       // Class of traffic -> Priority / VN / VC
                     INJECTION_TIME                          // Injection time to add
@@ -307,9 +342,11 @@ namespace coyote
             case NoCMessageType::MCPU_REQUEST:
             case NoCMessageType::SCRATCHPAD_ACK:
             case NoCMessageType::SCRATCHPAD_DATA_REPLY:
+                src_node = tile_to_network_[mess->getSrcPort()];
+                dst_node = mcpu_to_network_[mess->getDstPort()];
                 packet_id = booksim_wrappers_[mess->getNoCNetwork()]->GeneratePacket(
-                    tile_to_network_[mess->getSrcPort()],   // Source
-                    mcpu_to_network_[mess->getDstPort()],   // Destination
+                    src_node,                               // Source
+                    dst_node,                               // Destination
                     size,                                   // Number of flits
                     mess->getClass(),                       // Class of traffic -> Priority / VN / VC
                     INJECTION_TIME                          // Injection time to add
@@ -320,7 +357,9 @@ namespace coyote
             default:
                 sparta_assert(false);
         }
-        pkts_map_[mess->getNoCNetwork()][packet_id] = mess;
+        in_flight_pkts_[mess->getNoCNetwork()].insert(packet_id, mess, src_node);
+        if(link_stats_)
+            link_stats_->addPacket(mess->getNoCNetwork(), src_node, dst_node, size, getClock()->currentCycle());
         // Update sent flits for each network
         count_tx_flits_by_noc[mess->getNoCNetwork()] += size;
     }
@@ -333,16 +372,21 @@ namespace coyote
         int size = (int) ceil(1.0*mess->getSize()/network_width_[mess->getNoCNetwork()]); // message size and network_width are in bits
         sparta_assert(checkSpaceForPacket(INJECTED_BY_TILE, mess), "Insufficient space at injection queue, please ask before inject or review injection_queue_size parameter");
         sparta_assert(size <= ejection_queue_size_, "Packet size is bigger than output queue size, please review the ejection_queue_size parameter.");
+        catchUpIdleNetwork_(mess->getNoCNetwork());
         long packet_id = INVALID_PKT_ID;
+        uint16_t src_node = 0;
+        uint16_t dst_node = 0;
         switch(mess->getType())
         {
             // MEM -> VAS messages
             case NoCMessageType::MEMORY_ACK:
             case NoCMessageType::MCPU_REQUEST:
             case NoCMessageType::SCRATCHPAD_COMMAND:
+                src_node = mcpu_to_network_[mess->getSrcPort()];
+                dst_node = tile_to_network_[mess->getDstPort()];
                 packet_id = booksim_wrappers_[mess->getNoCNetwork()]->GeneratePacket(
-                    mcpu_to_network_[mess->getSrcPort()],   // Source
-                    tile_to_network_[mess->getDstPort()],   // Destination
+                    src_node,                               // Source
+                    dst_node,                               // Destination
                     size,                                   // Number of flits
                     mess->getClass(),                       // Class of traffic -> Priority / VN / VC
                     INJECTION_TIME                          // Injection time to add
@@ -353,9 +397,11 @@ namespace coyote
             // MEM -> MEM messages
             case NoCMessageType::MEM_TILE_REPLY:
             case NoCMessageType::MEM_TILE_REQUEST:
+                src_node = mcpu_to_network_[mess->getSrcPort()];
+                dst_node = mcpu_to_network_[mess->getDstPort()];
                 packet_id = booksim_wrappers_[mess->getNoCNetwork()]->GeneratePacket(
-                    mcpu_to_network_[mess->getSrcPort()],   // Source
-                    mcpu_to_network_[mess->getDstPort()],   // Destination
+                    src_node,                               // Source
+                    dst_node,                               // Destination
                     size,                                   // Number of flits
                     mess->getClass(),                       // Class of traffic -> Priority / VN / VC
                     INJECTION_TIME                          // Injection time to add
@@ -366,17 +412,38 @@ namespace coyote
             default:
                 sparta_assert(false);
         }
-        pkts_map_[mess->getNoCNetwork()][packet_id] = mess;
+        in_flight_pkts_[mess->getNoCNetwork()].insert(packet_id, mess, src_node);
+        if(link_stats_)
+            link_stats_->addPacket(mess->getNoCNetwork(), src_node, dst_node, size, getClock()->currentCycle());
         // Update sent flits for each network
         count_tx_flits_by_noc[mess->getNoCNetwork()] += size;
     }
 
+    void DetailedNoC::catchUpIdleNetwork_(const uint8_t network)
+    {
+        // The network is executed again from now on, so its clock must be in the same cycle than the rest of Coyote
+        network_idle_[network] = false;
+        while(pending_idle_cycles_[network] > 0)
+        {
+            uint16_t cycles = std::min(pending_idle_cycles_[network], static_cast<uint64_t>(std::numeric_limits<uint16_t>::max()));
+            booksim_wrappers_[network]->UpdateSimTime(cycles);
+            pending_idle_cycles_[network] -= cycles;
+        }
+    }
+
     void DetailedNoC::runBookSimCycles(const uint16_t cycles)
     {
         if(SPARTA_EXPECT_TRUE(cycles == 1)) // Run one cycle
         {
             for(uint8_t n=0; n < noc_networks_.size(); ++n)
             {
+                if(network_idle_[n])
+                {
+                    // Nothing to simulate, the clock is updated when the next packet is injected
+                    pending_idle_cycles_[n] += cycles;
+                    skipped_cycles_by_noc[n] += cycles;
+                    continue;
+                }
                 // Run BookSim
                 booksim_wrappers_[n]->RunCycles(cycles);
             }
@@ -385,21 +452,26 @@ namespace coyote
         {
             for(uint8_t n=0; n < noc_networks_.size(); ++n)
             {
-                sparta_assert(!booksim_wrappers_[n]->CheckInFlightPackets());
+                sparta_assert(network_idle_[n] && in_flight_pkts_[n].empty());
                 sparta_assert(cycles);
-                booksim_wrappers_[n]->UpdateSimTime(cycles);
+                pending_idle_cycles_[n] += cycles;
+                skipped_cycles_by_noc[n] += cycles;
             }
         }
     }
 
-    bool DetailedNoC::deliverOnePacketToDestination(const uint64_t current_cycle)
+    uint64_t DetailedNoC::deliverOnePacketToDestination(const uint64_t current_cycle)
     {
-        // {vas,mem}_queue_ are not used because the interface between Coyote and BookSim already has an ejection_queue and if this ejecion queue is not infinite
+        // delivery_queue_ is not used because the interface between Coyote and BookSim already has an ejection_queue and if this ejecion queue is not infinite
         // and we do not pick up the packet, this will propagate the congestion backward
         vector<bool> run_booksim_at_next_cycle = vector(noc_networks_.size(), false);
 
         for (uint8_t n = 0; n < noc_networks_.size(); ++n)
         {
+            // An idle network has nothing to retire
+            if(network_idle_[n])
+                continue;
+
             Booksim::BooksimWrapper::RetiredPacket pkt;
             
             for(uint16_t dst=0; dst < size_; dst++)
@@ -415,7 +487,7 @@ namespace coyote
                     if(pkt.pid != INVALID_PKT_ID)
                     {
                         // get the message
-                        mess = pkts_map_[n][pkt.pid];
+                        mess = in_flight_pkts_[n].find(pkt.pid);
                         // check if MT is able to receive the packet
                         if(!(*memoryTiles)[mess->getDstPort()]->ableToReceivePacket(mess))
                         {
@@ -431,10 +503,10 @@ namespace coyote
                     run_booksim_at_next_cycle[n] = true;
                     sparta_assert(pkt.dst == dst);
                     // Get the message
-                    mess = pkts_map_[n][pkt.pid];
+                    uint16_t src_node = in_flight_pkts_[n].getSource(pkt.pid);
+                    mess = in_flight_pkts_[n].erase(pkt.pid);
                     sparta_assert(mess->getNoCNetwork() == n);
                     sparta_assert(mess->getClass() == pkt.c);
-                    pkts_map_[n].erase(pkt.pid);
                     // Update statistics for each network
                     hop_count_by_noc[n] += pkt.hops;
                     count_rx_flits_by_noc[n] += pkt.ps;
@@ -443,6 +515,9 @@ namespace coyote
                     // Update statistics for each packet type
                     packet_latency_by_type[static_cast<int>(mess->getType())] += pkt.plat;
                     network_latency_by_type[static_cast<int>(mess->getType())] += pkt.nlat;
+                    // The router buffer occupancy is inferred from the network latency of the flits, spread along the route
+                    if(link_stats_)
+                        link_stats_->addRouterOccupancy(n, src_node, pkt.dst, 1.0 * pkt.ps * pkt.nlat, current_cycle);
                     // Send to the actual destination at NEXT_CYCLE
                     int rel_time = current_cycle + 1 - getClock()->currentCycle(); // rel_time to NEXT_CYCLE = current+1
                     sparta_assert(rel_time >= 0); // rel_time must be a cycle that sparta can run after current booksim iteration
@@ -454,6 +529,8 @@ namespace coyote
             }
             // If a packet has not been retired, BookSim may not have an event on the next cycle: check if there are packets or credits in flight.
             run_booksim_at_next_cycle[n] = run_booksim_at_next_cycle[n] || booksim_wrappers_[n]->CheckInFlightPackets() || booksim_wrappers_[n]->CheckInFlightCredits();
+            // Stop executing the network until a new packet is injected if it has neither packets nor credits in flight
+            network_idle_[n] = !run_booksim_at_next_cycle[n] && in_flight_pkts_[n].empty();
             
         }
 
@@ -462,7 +539,7 @@ namespace coyote
         for(uint8_t n=0; n < noc_networks_.size() && !any_network_needs_to_run_at_next_cycle; ++n)
             any_network_needs_to_run_at_next_cycle |= run_booksim_at_next_cycle[n];
 
-        return any_network_needs_to_run_at_next_cycle;
+        return any_network_needs_to_run_at_next_cycle ? current_cycle + 1 : NO_PENDING_DELIVERY;
     }
 
 } // coyote
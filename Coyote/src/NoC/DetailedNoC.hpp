@@ -22,6 +22,7 @@
 #define __DETAILED_NOC_H__
 
 #include "NoC.hpp"
+#include "InFlightPacketTable.hpp"
 #include "booksim_wrapper.hpp"
 
 using std::string;
@@ -58,7 +59,6 @@ namespace coyote
             {
             }
             PARAMETER(string, booksim_configuration, "4x4_mesh_iq.cfg", "The configuration file to load by BookSim")
-            PARAMETER(vector<uint16_t>, network_width, vector<uint16_t>({584,80,80}), "Physical channel width for the networks (bits)")
             PARAMETER(string, stats_files_prefix, "booksimstats", "The prefix of the booksim output statistics file")
         };
 
@@ -85,6 +85,7 @@ namespace coyote
          * 
          * Executes a cycle of BookSim simulator. After that, it tries to retire a packet from the NoC and return if there are packets in NoC.
          * If are called with cycles > 2, it updates the BookSim internal clock
+         * The networks without packets nor credits in flight are not executed, their clock is updated when the next packet is injected
          * 
          * \param cycles The number of cycles to simulate (typically 1)
          * \note This function is not executed under Sparta management, so, the getClock()->currentCycle() is pointing to the latest+1 cycle managed by Sparta
@@ -93,11 +94,10 @@ namespace coyote
         /*!
          * \brief Extract, at maximum, one packet for each destination in each network and send them through ports
          * \param current_cycle The current clock managed by simulator_orchestrator
-         * \return true If must be executed on the next Coyote cycle
-         * \return false If there is no packet in network and could not be executed in the next Coyote cycle
+         * \return The next Coyote cycle if BookSim must be executed on it, NO_PENDING_DELIVERY if there is no packet in network
          * \note This function is not executed under Sparta management, so, the getClock()->currentCycle() is pointing to the latest+1 cycle managed by Sparta
          */
-        virtual bool deliverOnePacketToDestination(const uint64_t current_cycle) override;
+        virtual uint64_t deliverOnePacketToDestination(const uint64_t current_cycle) override;
 
          /*! 
          * \brief Forwards a message from TILE to the actual destination using BookSim
@@ -113,6 +113,13 @@ namespace coyote
          */
         void handleMessageFromMemoryCPU_(const shared_ptr<NoCMessage> & mess) override;
 
+        /*!
+         * \brief Update the BookSim clock of an idle network with the cycles that have not been simulated
+         * \param network The network
+         * \note Must be called before injecting a packet and before reading the BookSim statistics
+         */
+        void catchUpIdleNetwork_(const uint8_t network);
+
         string                                  booksim_configuration_;     //! The configuration file to load in BookSim
         uint16_t                                ejection_queue_size_;       //! The configured ejection queue size
         vector<Booksim::BooksimWrapper*>        booksim_wrappers_;          //! BookSim library pointer for each NoC network
@@ -121,7 +128,10 @@ namespace coyote
         vector<bool>                            network_is_mcpu_;           //! A network id is a MCPU or a TILE
         vector<uint16_t>                        network_width_;             //! Physical channel width (bits)
         string                                  stats_files_prefix_;        //! The prefix of the output statistics files
-        vector<map<long,shared_ptr<NoCMessage>>> pkts_map_;                 //! Map that contains in-flight packets and their messages
+        vector<InFlightPacketTable>             in_flight_pkts_;                  //! Table that contains in-flight packets and their messages for each NoC
+        vector<bool>                            network_idle_;              //! The network has neither packets nor credits in flight
+        vector<uint64_t>                        pending_idle_cycles_;       //! The cycles that an idle network has not been executed
+        std::vector<sparta::Counter>            skipped_cycles_by_noc;      //! The number of cycles in which each NoC was not executed
         std::vector<sparta::Counter>            hop_count_by_noc;           //! Tracks the hop count for each NoC network
         std::vector<sparta::Counter>            count_rx_flits_by_noc;      //! The number of flits received by each NoC
         std::vector<sparta::Counter>            count_tx_flits_by_noc;      //! The number of flits sent in each NoC
@@ -42,7 +42,11 @@ namespace coyote
             // VAS -> VAS messages
             case NoCMessageType::REMOTE_L2_REQUEST:
             case NoCMessageType::REMOTE_L2_ACK:
-                vas_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + packet_latency_));
+            case NoCMessageType::COHERENCE_REQUEST:
+            case NoCMessageType::COHERENCE_INVALIDATE:
+            case NoCMessageType::COHERENCE_FORWARD:
+            case NoCMessageType::COHERENCE_ACK:
+                delivery_queue_.push(mess->getNoCNetwork(), false, mess->getDstPort(), mess, getClock()->currentCycle() + packet_latency_);
                 break;
 
             // VAS -> MCPU messages
@@ -52,7 +56,7 @@ namespace coyote
             case NoCMessageType::MCPU_REQUEST:
             case NoCMessageType::SCRATCHPAD_ACK:
             case NoCMessageType::SCRATCHPAD_DATA_REPLY:
-                mem_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + packet_latency_));
+                delivery_queue_.push(mess->getNoCNetwork(), true, mess->getDstPort(), mess, getClock()->currentCycle() + packet_latency_);
                 break;
 
             default:
@@ -70,12 +74,12 @@ namespace coyote
             case NoCMessageType::MEMORY_ACK:
             case NoCMessageType::MCPU_REQUEST:
             case NoCMessageType::SCRATCHPAD_COMMAND:
-                vas_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + packet_latency_));
+                delivery_queue_.push(mess->getNoCNetwork(), false, mess->getDstPort(), mess, getClock()->currentCycle() + packet_latency_);
                 break;
             // MemoryTile -> Memory Tile Communication
             case NoCMessageType::MEM_TILE_REQUEST:
             case NoCMessageType::MEM_TILE_REPLY:
-                mem_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + packet_latency_));
+                delivery_queue_.push(mess->getNoCNetwork(), true, mess->getDstPort(), mess, getClock()->currentCycle() + packet_latency_);
                 break;
 
             default:
@@ -0,0 +1,174 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __IN_FLIGHT_PACKET_TABLE_H__
+#define __IN_FLIGHT_PACKET_TABLE_H__
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace coyote
+{
+    class NoCMessage;
+
+    /*!
+     * \class coyote::InFlightPacketTable
+     * \brief The messages and source nodes of the packets in flight in a BookSim network, indexed by packet id.
+     *
+     * BookSim assigns increasing ids to the packets of a network, so the ids in flight at any time fall in a window
+     * and the table is a power-of-two array of slots indexed by the id modulo its capacity. Insertions, lookups and
+     * removals do not allocate. If the window of ids in flight grows beyond the capacity and two ids map to the
+     * same slot, the capacity is doubled.
+     */
+    class InFlightPacketTable
+    {
+        public:
+            /*!
+             * \brief Constructor for InFlightPacketTable
+             * \param capacity The initial number of slots, rounded up to a power of two
+             */
+            explicit InFlightPacketTable(size_t capacity) :
+                slots_(roundUpToPowerOfTwo_(capacity)),
+                mask_(slots_.size()-1),
+                size_(0)
+            {}
+
+            /*!
+             * \brief Add a packet
+             * \param id The id of the packet, must be non-negative and not in the table
+             * \param mess The message carried by the packet
+             * \param source The node that injected the packet
+             */
+            void insert(long id, const std::shared_ptr<NoCMessage>& mess, uint16_t source)
+            {
+                sparta_assert(id >= 0);
+                while(slots_[id & mask_].id != INVALID_ID)
+                {
+                    sparta_assert(slots_[id & mask_].id != id, "Packet " << id << " is already in flight");
+                    grow_();
+                }
+                slots_[id & mask_] = Slot{id, source, mess};
+                size_++;
+            }
+
+            /*!
+             * \brief Get the message of a packet
+             * \param id The id of the packet, must be in the table
+             * \return The message
+             */
+            const std::shared_ptr<NoCMessage>& find(long id) const
+            {
+                const Slot& s = slots_[id & mask_];
+                sparta_assert(s.id == id, "Packet " << id << " is not in flight");
+                return s.mess;
+            }
+
+            /*!
+             * \brief Get the node that injected a packet
+             * \param id The id of the packet, must be in the table
+             * \return The source node
+             */
+            uint16_t getSource(long id) const
+            {
+                const Slot& s = slots_[id & mask_];
+                sparta_assert(s.id == id, "Packet " << id << " is not in flight");
+                return s.source;
+            }
+
+            /*!
+             * \brief Remove a packet
+             * \param id The id of the packet, must be in the table
+             * \return The message of the packet
+             */
+            std::shared_ptr<NoCMessage> erase(long id)
+            {
+                Slot& s = slots_[id & mask_];
+                sparta_assert(s.id == id, "Packet " << id << " is not in flight");
+                s.id = INVALID_ID;
+                size_--;
+                return std::move(s.mess);
+            }
+
+            /*!
+             * \brief Get the number of packets in flight
+             * \return The number of packets
+             */
+            size_t size() const
+            {
+                return size_;
+            }
+
+            /*!
+             * \brief Check if there are no packets in flight
+             * \return true if there are no packets
+             */
+            bool empty() const
+            {
+                return size_ == 0;
+            }
+
+        private:
+            static constexpr long INVALID_ID = -1; //! Marks a free slot
+
+            struct Slot
+            {
+                long id = INVALID_ID;
+                uint16_t source = 0;
+                std::shared_ptr<NoCMessage> mess;
+            };
+
+            /*!
+             * \brief Round a number of slots up to a power of two
+             * \param n The number of slots
+             * \return The power of two
+             */
+            static size_t roundUpToPowerOfTwo_(size_t n)
+            {
+                size_t p = 1;
+                while(p < n)
+                    p <<= 1;
+                return p;
+            }
+
+            /*!
+             * \brief Double the capacity, moving the packets to their new slots
+             */
+            void grow_()
+            {
+                std::vector<Slot> larger(2*slots_.size());
+                size_t mask = larger.size()-1;
+                for(Slot& s : slots_)
+                {
+                    if(s.id != INVALID_ID)
+                        larger[s.id & mask] = std::move(s);
+                }
+                slots_.swap(larger);
+                mask_ = mask;
+            }
+
+            std::vector<Slot> slots_;   //! The slots, indexed by packet id modulo their number
+            size_t mask_;               //! The number of slots minus one
+            size_t size_;               //! The number of packets in flight
+    };
+}
+#endif
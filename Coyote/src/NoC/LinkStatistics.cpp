@@ -0,0 +1,196 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include "LinkStatistics.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace coyote
+{
+    LinkStatistics::LinkStatistics(const std::string& prefix, const std::vector<std::string>& networks, const std::vector<uint16_t>& dimensions,
+                                   bool wraparound, uint32_t interval, uint16_t top_n) :
+        prefix_(prefix),
+        networks_(networks),
+        dimensions_(dimensions),
+        wraparound_(wraparound),
+        interval_(interval),
+        top_n_(top_n),
+        num_routers_(std::accumulate(dimensions.begin(), dimensions.end(), 1, std::multiplies<uint32_t>())),
+        num_ports_(2*dimensions.size()+1),
+        interval_start_(0),
+        interval_flits_(networks.size()*num_routers_*num_ports_, 0),
+        total_flits_(networks.size()*num_routers_*num_ports_, 0),
+        interval_occupancy_(networks.size()*num_routers_, 0),
+        total_occupancy_(networks.size()*num_routers_, 0),
+        route_(),
+        link_files_(networks.size()),
+        router_files_(networks.size())
+    {
+        sparta_assert(!dimensions_.empty());
+        for(size_t n=0; n < networks_.size(); ++n)
+        {
+            link_files_[n].open(prefix_ + "links_" + networks_[n] + ".csv");
+            sparta_assert(link_files_[n].is_open(), "Could not open the link statistics file for " << networks_[n]);
+            link_files_[n] << "start;end;router;coordinates;port;flits;utilization\n";
+            router_files_[n].open(prefix_ + "routers_" + networks_[n] + ".csv");
+            sparta_assert(router_files_[n].is_open(), "Could not open the router statistics file for " << networks_[n]);
+            router_files_[n] << "start;end;router;coordinates;avg_buffer_occupancy\n";
+        }
+    }
+
+    void LinkStatistics::addPacket(uint8_t network, uint16_t src, uint16_t dst, uint16_t flits, uint64_t cycle)
+    {
+        update_(cycle);
+        computeRoute_(src, dst);
+        for(const auto& hop : route_)
+        {
+            size_t link = (network*num_routers_ + hop.first)*num_ports_ + hop.second;
+            interval_flits_[link] += flits;
+            total_flits_[link] += flits;
+        }
+    }
+
+    void LinkStatistics::addRouterOccupancy(uint8_t network, uint16_t src, uint16_t dst, double flit_cycles, uint64_t cycle)
+    {
+        update_(cycle);
+        computeRoute_(src, dst);
+        double flit_cycles_per_router = flit_cycles / route_.size();
+        for(const auto& hop : route_)
+        {
+            interval_occupancy_[network*num_routers_ + hop.first] += flit_cycles_per_router;
+            total_occupancy_[network*num_routers_ + hop.first] += flit_cycles_per_router;
+        }
+    }
+
+    void LinkStatistics::finish(uint64_t cycle)
+    {
+        update_(cycle);
+        if(interval_ != 0 && cycle > interval_start_)
+            writeInterval_(interval_start_, cycle);
+
+        // The totals are written as an interval that covers the whole simulation
+        interval_flits_.swap(total_flits_);
+        interval_occupancy_.swap(total_occupancy_);
+        std::vector<uint64_t> flits = interval_flits_;
+        writeInterval_(0, cycle);
+
+        // Report of the most utilized links of each network, ranked separately as their widths may differ
+        std::ofstream report(prefix_ + "top_links.csv");
+        sparta_assert(report.is_open(), "Could not open the congested links report");
+        report << "rank;network;router;coordinates;port;flits;utilization\n";
+        size_t links_per_network = static_cast<size_t>(num_routers_) * num_ports_;
+        std::vector<size_t> links(links_per_network);
+        size_t reported = std::min(links_per_network, static_cast<size_t>(top_n_));
+        for(size_t n=0; n < networks_.size(); ++n)
+        {
+            std::iota(links.begin(), links.end(), n * links_per_network);
+            std::partial_sort(links.begin(), links.begin() + reported, links.end(),
+                [&flits](size_t a, size_t b){return flits[a] > flits[b] || (flits[a] == flits[b] && a < b);});
+            for(size_t i=0; i < reported; ++i)
+            {
+                size_t link = links[i];
+                uint8_t port = link % num_ports_;
+                uint16_t router = (link / num_ports_) % num_routers_;
+                report << i+1 << ";" << networks_[n] << ";" << router << ";" << getCoordinates_(router) << ";" << getPortName_(port) << ";"
+                       << flits[link] << ";" << (cycle ? 1.0 * flits[link] / cycle : 0) << "\n";
+            }
+        }
+    }
+
+    void LinkStatistics::update_(uint64_t cycle)
+    {
+        if(interval_ == 0)
+            return;
+        while(cycle >= interval_start_ + interval_)
+        {
+            writeInterval_(interval_start_, interval_start_ + interval_);
+            interval_start_ += interval_;
+        }
+    }
+
+    void LinkStatistics::writeInterval_(uint64_t start, uint64_t end)
+    {
+        uint64_t cycles = end - start;
+        for(size_t n=0; n < networks_.size(); ++n)
+        {
+            for(uint16_t r=0; r < num_routers_; ++r)
+            {
+                std::string coordinates = getCoordinates_(r);
+                for(uint8_t p=0; p < num_ports_; ++p)
+                {
+                    uint64_t& flits = interval_flits_[(n*num_routers_ + r)*num_ports_ + p];
+                    link_files_[n] << start << ";" << end << ";" << r << ";" << coordinates << ";" << getPortName_(p) << ";"
+                                   << flits << ";" << (cycles ? 1.0 * flits / cycles : 0) << "\n";
+                    flits = 0;
+                }
+                double& occupancy = interval_occupancy_[n*num_routers_ + r];
+                router_files_[n] << start << ";" << end << ";" << r << ";" << coordinates << ";" << (cycles ? occupancy / cycles : 0) << "\n";
+                occupancy = 0;
+            }
+        }
+    }
+
+    void LinkStatistics::computeRoute_(uint16_t src, uint16_t dst)
+    {
+        route_.clear();
+        uint16_t current = src;
+        uint32_t stride = 1;
+        for(uint8_t d=0; d < dimensions_.size(); ++d)
+        {
+            int size = dimensions_[d];
+            int from = (current / stride) % size;
+            int to = (dst / stride) % size;
+            int forward = (to - from + size) % size;
+            // Increasing coordinates unless going backwards is shorter (or there are no wraparound links)
+            bool increasing = wraparound_ ? forward <= size - forward : to > from;
+            while(from != to)
+            {
+                route_.push_back(std::make_pair(current, 2*d + (increasing ? 0 : 1)));
+                int next = increasing ? (from + 1) % size : (from - 1 + size) % size;
+                current = current + (next - from) * static_cast<int>(stride);
+                from = next;
+            }
+            stride *= size;
+        }
+        sparta_assert(current == dst);
+        route_.push_back(std::make_pair(dst, num_ports_ - 1));
+    }
+
+    std::string LinkStatistics::getPortName_(uint8_t port) const
+    {
+        if(port == num_ports_ - 1)
+            return "ejection";
+        const char* axes = "xyz";
+        std::string name(1, port/2 < 3 ? axes[port/2] : '?');
+        return name + (port % 2 == 0 ? "+" : "-");
+    }
+
+    std::string LinkStatistics::getCoordinates_(uint16_t router) const
+    {
+        std::ostringstream coordinates;
+        for(uint8_t d=0; d < dimensions_.size(); ++d)
+        {
+            coordinates << (d ? "," : "") << router % dimensions_[d];
+            router /= dimensions_[d];
+        }
+        return coordinates.str();
+    }
+}
@@ -0,0 +1,135 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __LINK_STATISTICS_H__
+#define __LINK_STATISTICS_H__
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace coyote
+{
+    /*!
+     * \class coyote::LinkStatistics
+     * \brief Per-link flit counts and per-router buffer occupancy of the NoC networks, with a report of the most congested links
+     *
+     * The routers form a mesh (or a torus, if the dimensions wrap around) of one or more dimensions, and packets follow
+     * dimension-order routes, taking the shortest direction in wrapped dimensions. Each router has two output links per
+     * dimension (towards increasing and decreasing coordinates) and an ejection link. The flits that traverse each link and
+     * the buffer occupancy of each router, in flit-cycles, are written for each interval to a CSV file per network. When
+     * the simulation finishes, the links with the highest utilization of each network are written to a separate report.
+     */
+    class LinkStatistics
+    {
+        public:
+            /*!
+             * \brief Constructor for LinkStatistics
+             * \param prefix The prefix of the output files
+             * \param networks The names of the networks
+             * \param dimensions The number of routers in each dimension
+             * \param wraparound Whether the dimensions wrap around (torus or ring)
+             * \param interval The number of cycles of each interval, 0 only writes the totals
+             * \param top_n The number of links of each network in the congestion report
+             */
+            LinkStatistics(const std::string& prefix, const std::vector<std::string>& networks, const std::vector<uint16_t>& dimensions,
+                           bool wraparound, uint32_t interval, uint16_t top_n);
+
+            /*!
+             * \brief Account the flits of a packet in the links of its route
+             * \param network The network of the packet
+             * \param src The source router
+             * \param dst The destination router
+             * \param flits The size of the packet in flits
+             * \param cycle The current cycle
+             */
+            void addPacket(uint8_t network, uint16_t src, uint16_t dst, uint16_t flits, uint64_t cycle);
+
+            /*!
+             * \brief Account the buffer occupancy of a packet, spread evenly among the routers of its route including the destination
+             * \param network The network of the packet
+             * \param src The source router
+             * \param dst The destination router
+             * \param flit_cycles The flit-cycles that the packet spends buffered in the network
+             * \param cycle The current cycle
+             */
+            void addRouterOccupancy(uint8_t network, uint16_t src, uint16_t dst, double flit_cycles, uint64_t cycle);
+
+            /*!
+             * \brief Write the statistics of the last interval, the totals and the congestion report
+             * \param cycle The current cycle
+             */
+            void finish(uint64_t cycle);
+
+        private:
+            /*!
+             * \brief Write the statistics of the intervals that have finished before a cycle
+             * \param cycle The current cycle
+             */
+            void update_(uint64_t cycle);
+
+            /*!
+             * \brief Write the statistics of an interval and reset them
+             * \param start The first cycle of the interval
+             * \param end The cycle after the last one of the interval
+             */
+            void writeInterval_(uint64_t start, uint64_t end);
+
+            /*!
+             * \brief Get the routers, and the output ports taken in each of them, of a dimension-order route
+             * \param src The source router
+             * \param dst The destination router
+             * \note The result is left in route_, the last hop uses the ejection port of dst
+             */
+            void computeRoute_(uint16_t src, uint16_t dst);
+
+            /*!
+             * \brief Get the name of a port
+             * \param port The port
+             * \return The name
+             */
+            std::string getPortName_(uint8_t port) const;
+
+            /*!
+             * \brief Get the coordinates of a router
+             * \param router The router
+             * \return The coordinates separated by ','
+             */
+            std::string getCoordinates_(uint16_t router) const;
+
+            std::string prefix_;                                //! The prefix of the output files
+            std::vector<std::string> networks_;                 //! The names of the networks
+            std::vector<uint16_t> dimensions_;                  //! The number of routers in each dimension
+            bool wraparound_;                                   //! The dimensions wrap around
+            uint32_t interval_;                                 //! The cycles of each interval (0 disables them)
+            uint16_t top_n_;                                    //! The number of links of each network in the congestion report
+            uint16_t num_routers_;                              //! The number of routers
+            uint8_t num_ports_;                                 //! The number of output ports of each router
+            uint64_t interval_start_;                           //! The first cycle of the current interval
+            std::vector<uint64_t> interval_flits_;              //! Flits in the current interval indexed by network, router and port
+            std::vector<uint64_t> total_flits_;                 //! Flits in the whole simulation indexed by network, router and port
+            std::vector<double> interval_occupancy_;            //! Flit-cycles in the current interval indexed by network and router
+            std::vector<double> total_occupancy_;               //! Flit-cycles in the whole simulation indexed by network and router
+            std::vector<std::pair<uint16_t, uint8_t>> route_;   //! The (router, output port) hops of the last computed route
+            std::vector<std::ofstream> link_files_;             //! The interval link statistics of each network
+            std::vector<std::ofstream> router_files_;           //! The interval router statistics of each network
+    };
+}
+#endif
@@ -42,7 +42,13 @@ namespace coyote
         mcpus_indices_(params->mcpus_indices),
         noc_model_(params->noc_model),
         max_class_used_(0),
-        noc_networks_(params->noc_networks)
+        noc_networks_(params->noc_networks),
+        delivery_queue_(noc_networks_.size(), num_tiles_, num_memory_cpus_),
+        due_deliveries_(),
+        link_stats_prefix_(params->link_stats_prefix),
+        link_stats_interval_(params->link_stats_interval),
+        link_stats_top_n_(params->link_stats_top_n),
+        link_stats_()
     {
         for(uint16_t i=0; i<num_tiles_; i++)
         {
@@ -113,15 +119,6 @@ namespace coyote
         }
         sparta_assert(NoC::message_to_network_and_class_.size() == static_cast<int>(NoCMessageType::count));
 
-        // Packets queue
-        vas_queue_.resize(noc_networks_.size());
-        mem_queue_.resize(noc_networks_.size());
-        for (uint8_t noc = 0; noc < noc_networks_.size(); noc++)
-        {
-            vas_queue_.at(noc).resize(num_tiles_);
-            mem_queue_.at(noc).resize(num_memory_cpus_);
-        }
-
         // Statistics
         for(auto network : noc_networks_)
         {
@@ -185,6 +182,10 @@ namespace coyote
             // VAS -> VAS messages
             case NoCMessageType::REMOTE_L2_REQUEST:
             case NoCMessageType::REMOTE_L2_ACK:
+            case NoCMessageType::COHERENCE_REQUEST:
+            case NoCMessageType::COHERENCE_INVALIDATE:
+            case NoCMessageType::COHERENCE_FORWARD:
+            case NoCMessageType::COHERENCE_ACK:
             // VAS -> MEM messages
             case NoCMessageType::MEMORY_REQUEST_LOAD:
             case NoCMessageType::MEMORY_REQUEST_STORE:
@@ -203,60 +204,46 @@ namespace coyote
         }
     }
 
-    bool NoC::deliverOnePacketToDestination(const uint64_t current_cycle)
+    void NoC::enableLinkStatistics_(const vector<uint16_t>& dimensions, bool wraparound)
+    {
+        if(!link_stats_prefix_.empty())
+            link_stats_ = std::make_unique<LinkStatistics>(link_stats_prefix_, noc_networks_, dimensions, wraparound, link_stats_interval_, link_stats_top_n_);
+    }
+
+    uint64_t NoC::deliverOnePacketToDestination(const uint64_t current_cycle)
     {
-        vector<bool> run_noc_at_next_cycle = vector(noc_networks_.size(), false);
         // Like in detailed model we have a packet latency of X that does not include ejection latency and then, we eject the packets always 1 cycle later.
         // Hence, here it is ejected the packet at NEXT cycle (current + 1) to always use the concept of packet latency in the same way
         int rel_time = current_cycle + 1 - getClock()->currentCycle(); // getClock()->currentCycle() points to latest cycle + 1
-        for (uint8_t noc = 0; noc < noc_networks_.size(); ++noc)
+        // Only the destinations with a packet due are visited, in the same network, tile and memory CPU order as a full scan
+        delivery_queue_.getDue(current_cycle, due_deliveries_);
+        for(uint32_t slot : due_deliveries_)
         {
-            // vas
-            for(uint16_t vas = 0; vas < num_tiles_; vas++)
+            std::shared_ptr<NoCMessage> mess = delivery_queue_.front(slot);
+            uint16_t dst = delivery_queue_.getDestination(slot);
+            if(!delivery_queue_.isMemoryCPU(slot))
             {
-                // check if there is a packet to this vas tile
-                if(!vas_queue_.at(noc).at(vas).empty() && vas_queue_.at(noc).at(vas).front().second <= current_cycle)
-                {
-                    std::shared_ptr<NoCMessage> mess = vas_queue_.at(noc).at(vas).front().first;
-                    // Send to the actual destination at current + packet_latency_
-                    out_ports_tiles_[vas]->send(mess, rel_time);
-                    vas_queue_.at(noc).at(vas).erase(vas_queue_.at(noc).at(vas).begin());
-                }
-                // check if the are packets to be extracted at next cycle
-                if(!run_noc_at_next_cycle[noc] && !vas_queue_.at(noc).at(vas).empty())
-                    run_noc_at_next_cycle[noc] = true;
+                // Send to the actual destination at current + packet_latency_
+                out_ports_tiles_[dst]->send(mess, rel_time);
             }
-            // mem
-            for(uint16_t mem = 0; mem < num_memory_cpus_; mem++)
+            else
             {
-                // check if there is a packet to this mem tile
-                if(!mem_queue_.at(noc).at(mem).empty() && mem_queue_.at(noc).at(mem).front().second <= current_cycle)
+                sparta_assert(dst == mess->getDstPort());
+                // check if memory tile is able to receive the packet
+                // Memory tiles have the "magical" capability of being able to check if its next packet can be received
+                // by analyzing it without actually receiving it
+                if(!(*memoryTiles)[dst]->ableToReceivePacket(mess))
                 {
-                    std::shared_ptr<NoCMessage> mess = mem_queue_.at(noc).at(mem).front().first;
-                    sparta_assert(mem == mess->getDstPort());
-                    // check if memory tile is able to receive the packet
-                    // Memory tiles have the "magical" capability of being able to check if its next packet can be received
-                    // by analyzing it without actually receiving it
-                    if(!(*memoryTiles)[mem]->ableToReceivePacket(mess))
-                    {
-                        run_noc_at_next_cycle[noc] = true;
-                        continue; // continue if MT is not able to receive the packet
-                    }
-                    // Send to the actual destination at current + packet_latency_
-                    out_ports_memory_cpus_[mem]->send(mess, rel_time);
-                    mem_queue_.at(noc).at(mem).erase(mem_queue_.at(noc).at(mem).begin());
+                    delivery_queue_.retry(slot, current_cycle);
+                    continue; // continue if MT is not able to receive the packet
                 }
-                // check if the are packets to be extracted at next cycle
-                if(!run_noc_at_next_cycle[noc] && !mem_queue_.at(noc).at(mem).empty())
-                    run_noc_at_next_cycle[noc] = true;
+                // Send to the actual destination at current + packet_latency_
+                out_ports_memory_cpus_[dst]->send(mess, rel_time);
             }
+            delivery_queue_.pop(slot, current_cycle);
         }
-        // Return if any NoC network needs to be executed at the next cycle
-        bool any_network_needs_to_run_at_next_cycle = false;
-        for(uint8_t noc=0; noc < noc_networks_.size() && !any_network_needs_to_run_at_next_cycle; ++noc)
-            any_network_needs_to_run_at_next_cycle |= run_noc_at_next_cycle[noc];
-
-        return any_network_needs_to_run_at_next_cycle;
+        // Return the next cycle in which the NoC needs to be executed
+        return delivery_queue_.getNextCycle();
     }
 
     void NoC::traceSrcDst_(const std::shared_ptr<NoCMessage> & mess)
@@ -43,6 +43,8 @@
 
 #include "NoCMessage.hpp"
 #include "NoCMessageType.hpp"
+#include "PacketDeliveryQueue.hpp"
+#include "LinkStatistics.hpp"
 #include "../LogCapable.hpp"
 
 using std::vector;
@@ -82,7 +84,7 @@ namespace coyote
             PARAMETER(uint16_t, x_size, 2, "The size of X dimension")
             PARAMETER(uint16_t, y_size, 1, "The size of Y dimension")
             PARAMETER(std::vector<uint16_t>, mcpus_indices, {0}, "The indices of MCPUs in the network ordered by MCPU")
-            PARAMETER(std::string, noc_model, "functional", "The noc model to use (functional, simple, detailed)")
+            PARAMETER(std::string, noc_model, "functional", "The noc model to use (functional, simple, analytical, detailed)")
             PARAMETER(std::vector<std::string>, noc_networks, std::vector<std::string>(
                 {"DATA_TRANSFER",
                  "ADDRESS_ONLY",
@@ -97,7 +99,13 @@ namespace coyote
                  "MCPU_REQUEST:8",
                  "SCRATCHPAD_ACK:8",
                  "SCRATCHPAD_DATA_REPLY:8",
-                 "SCRATCHPAD_COMMAND:8"}), "The header size of each message including CRC (in bits)")
+                 "SCRATCHPAD_COMMAND:8",
+                 "MEM_TILE_REQUEST:8",
+                 "MEM_TILE_REPLY:8",
+                 "COHERENCE_REQUEST:8",
+                 "COHERENCE_INVALIDATE:8",
+                 "COHERENCE_FORWARD:8",
+                 "COHERENCE_ACK:8"}), "The header size of each message including CRC (in bits)")
             PARAMETER(std::vector<std::string>, message_to_network_and_class, std::vector<std::string>(
                 {"REMOTE_L2_REQUEST:ADDRESS_ONLY.1",
                  "MEMORY_REQUEST_LOAD:ADDRESS_ONLY.1",
@@ -110,12 +118,22 @@ namespace coyote
                  "SCRATCHPAD_DATA_REPLY:DATA_TRANSFER.2",
                  "SCRATCHPAD_COMMAND:DATA_TRANSFER.3",
                  "MEM_TILE_REQUEST:DATA_TRANSFER.2",
-                 "MEM_TILE_REPLY:DATA_TRANSFER.2"}), "Mapping of messages to networks and classes")
+                 "MEM_TILE_REPLY:DATA_TRANSFER.2",
+                 "COHERENCE_REQUEST:ADDRESS_ONLY.1",
+                 "COHERENCE_INVALIDATE:ADDRESS_ONLY.1",
+                 "COHERENCE_FORWARD:ADDRESS_ONLY.1",
+                 "COHERENCE_ACK:CONTROL.0"}), "Mapping of messages to networks and classes")
+            PARAMETER(std::vector<uint16_t>, network_width, std::vector<uint16_t>({584,80,80}), "Physical channel width for the networks (bits), used by the analytical and detailed models and the link statistics")
+            PARAMETER(std::string, link_stats_prefix, "", "If not empty, the prefix of the per-link and per-router statistics files (simple, analytical and detailed models)")
+            PARAMETER(uint32_t, link_stats_interval, 100000, "The number of cycles of each interval of the link statistics (0 only writes the totals)")
+            PARAMETER(uint16_t, link_stats_top_n, 10, "The number of links of each network in the report of the most congested links")
         };
 
         //! name of this resource.
         static const char name[];
 
+        static constexpr uint64_t NO_PENDING_DELIVERY=PacketDeliveryQueue::NO_PENDING_DELIVERY; //! There are no packets to deliver
+
         static uint8_t getNetworkForMessage(const NoCMessageType mess);
         static uint8_t getClassForMessage(const NoCMessageType mess);
         const std::string getNetworkName(const uint8_t noc);
@@ -144,12 +162,12 @@ namespace coyote
         /*!
          * \brief Extract, at maximum, one packet for each destination in each network and send them through ports
          * \param current_cycle The current clock managed by simulator_orchestrator
-         * \return true If must be executed on the next Coyote cycle
-         * \return false If there is no packet in network and could not be executed in the next Coyote cycle
+         * \return The next cycle in which the NoC has a packet to deliver, or NO_PENDING_DELIVERY if there are no packets in the network
          * \note This function is not executed under Sparta management, so, the getClock()->currentCycle() is pointing to the latest+1 cycle managed by Sparta
-         * \note THis function is override is Detailed model because this model does not use the {vas,mem}_queue because the interface has its own ejection queue
+         * \note Only the destinations with a packet due in current_cycle are visited
+         * \note THis function is override is Detailed model because this model does not use the delivery_queue_ because the interface has its own ejection queue
          */
-        virtual bool deliverOnePacketToDestination(const uint64_t current_cycle);
+        virtual uint64_t deliverOnePacketToDestination(const uint64_t current_cycle);
 
         void setMemoryTiles(std::shared_ptr<std::vector<MemoryCPUWrapper *>> &newMemoryTiles);
 
@@ -169,11 +187,20 @@ namespace coyote
 
         ~NoC() 
         {
+            if(link_stats_)
+                link_stats_->finish(getClock()->currentCycle());
             debug_logger_ << getContainer()->getLocation()
                           << ": "
                           << std::endl;
         }
 
+        /*!
+         * \brief Create the link statistics if they are enabled
+         * \param dimensions The number of routers in each dimension of the topology
+         * \param wraparound Whether the dimensions wrap around (torus or ring)
+         */
+        void enableLinkStatistics_(const vector<uint16_t>& dimensions, bool wraparound);
+
         /*!
          * \brief Get the Network From String object
          * 
@@ -186,8 +213,6 @@ namespace coyote
         vector<std::unique_ptr<sparta::DataOutPort<shared_ptr<NoCMessage>>>> out_ports_tiles_;
         vector<std::unique_ptr<sparta::DataInPort<shared_ptr<NoCMessage>>>> in_ports_memory_cpus_;
         vector<std::unique_ptr<sparta::DataOutPort<shared_ptr<NoCMessage>>>> out_ports_memory_cpus_;
-        vector<vector<vector<pair<shared_ptr<NoCMessage>, uint64_t>>>> vas_queue_;      //! Packets queue indexed by NoC and VAS destination
-        vector<vector<vector<pair<shared_ptr<NoCMessage>, uint64_t>>>> mem_queue_;      //! Packets queue indexed by NoC and MEM destination
         uint16_t                                        num_tiles_;                     //! The number of tiles connected
         uint16_t                                        num_memory_cpus_;               //! The number of memory cpus connected
         uint16_t                                        x_size_;                        //! The size of X dimension
@@ -197,10 +222,16 @@ namespace coyote
         std::string                                     noc_model_;                     //! The model of NoC to simulate
         uint8_t                                         max_class_used_;                //! The maximum class value used in messages
         vector<std::string>                             noc_networks_;                  //! The name of the defined NoC networks
+        PacketDeliveryQueue                             delivery_queue_;                //! Packets queue indexed by NoC and destination, ordered by delivery cycle
+        vector<uint32_t>                                due_deliveries_;                //! The destinations with a packet due in the current cycle
         /* Statistics */
         vector<sparta::Counter> count_rx_packets_;                                      //! The number of packets received in each NoC
         vector<sparta::Counter> count_tx_packets_;                                      //! The number of packets sent in each NoC
         std::shared_ptr<std::vector<MemoryCPUWrapper *>> memoryTiles;
+        std::string                                     link_stats_prefix_;             //! The prefix of the link statistics files (empty if disabled)
+        uint32_t                                        link_stats_interval_;           //! The cycles of each interval of the link statistics
+        uint16_t                                        link_stats_top_n_;              //! The number of links of each network in the congestion report
+        std::unique_ptr<LinkStatistics>                 link_stats_;                    //! The per-link and per-router statistics (nullptr if disabled)
 
     private:
 
@@ -224,6 +255,10 @@ namespace coyote
             else if (mess == "SCRATCHPAD_COMMAND") return NoCMessageType::SCRATCHPAD_COMMAND;
             else if (mess == "MEM_TILE_REQUEST") return NoCMessageType::MEM_TILE_REQUEST;
             else if (mess == "MEM_TILE_REPLY") return NoCMessageType::MEM_TILE_REPLY;
+            else if (mess == "COHERENCE_REQUEST") return NoCMessageType::COHERENCE_REQUEST;
+            else if (mess == "COHERENCE_INVALIDATE") return NoCMessageType::COHERENCE_INVALIDATE;
+            else if (mess == "COHERENCE_FORWARD") return NoCMessageType::COHERENCE_FORWARD;
+            else if (mess == "COHERENCE_ACK") return NoCMessageType::COHERENCE_ACK;
             else sparta_assert(false, "Message " + mess + " not defined. See NoCMessageType.");
         }
 
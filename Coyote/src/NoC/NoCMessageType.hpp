@@ -85,7 +85,30 @@ namespace coyote
          */
         MEM_TILE_REPLY          =11,
         
-        count                   =12 // Number of message types
+        /**
+         * A coherence request (GetS, GetM or PutM) sent by a VAS Tile to the Tile that holds the
+         * directory entry of the line.
+         */
+        COHERENCE_REQUEST       =12,
+        
+        /**
+         * An invalidation sent by the directory to a VAS Tile that holds a copy of the line.
+         */
+        COHERENCE_INVALIDATE    =13,
+        
+        /**
+         * A forward sent by the directory to the VAS Tile that owns a modified line, which has to write
+         * it back and downgrade its copy to shared.
+         */
+        COHERENCE_FORWARD       =14,
+        
+        /**
+         * The reply to a COHERENCE_INVALIDATE or a COHERENCE_FORWARD, or the grant of a GetS or GetM
+         * that the directory sends to the requester once they are acknowledged.
+         */
+        COHERENCE_ACK           =15,
+        
+        count                   =16 // Number of message types
     };
 
     inline std::ostream& operator<<(std::ostream& os, NoCMessageType nmt)
@@ -104,6 +127,10 @@ namespace coyote
             case NoCMessageType::SCRATCHPAD_COMMAND: os << "SCRATCHPAD_COMMAND"; return os;
             case NoCMessageType::MEM_TILE_REQUEST: os << "MEM_TILE_REQUEST"; return os;
             case NoCMessageType::MEM_TILE_REPLY: os << "MEM_TILE_REPLY"; return os;
+            case NoCMessageType::COHERENCE_REQUEST: os << "COHERENCE_REQUEST"; return os;
+            case NoCMessageType::COHERENCE_INVALIDATE: os << "COHERENCE_INVALIDATE"; return os;
+            case NoCMessageType::COHERENCE_FORWARD: os << "COHERENCE_FORWARD"; return os;
+            case NoCMessageType::COHERENCE_ACK: os << "COHERENCE_ACK"; return os;
             default: os << "UNKNOWN_NoCMessageType"; return os;
         }
     }
@@ -124,6 +151,10 @@ namespace coyote
             case NoCMessageType::SCRATCHPAD_COMMAND: return str.append("SCRATCHPAD_COMMAND");
             case NoCMessageType::MEM_TILE_REQUEST: return str.append("MEM_TILE_REQUEST");
             case NoCMessageType::MEM_TILE_REPLY: return str.append("MEM_TILE_REPLY");
+            case NoCMessageType::COHERENCE_REQUEST: return str.append("COHERENCE_REQUEST");
+            case NoCMessageType::COHERENCE_INVALIDATE: return str.append("COHERENCE_INVALIDATE");
+            case NoCMessageType::COHERENCE_FORWARD: return str.append("COHERENCE_FORWARD");
+            case NoCMessageType::COHERENCE_ACK: return str.append("COHERENCE_ACK");
             default: sparta_assert(false);
         }
     }
@@ -0,0 +1,225 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __PACKET_DELIVERY_QUEUE_H__
+#define __PACKET_DELIVERY_QUEUE_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace coyote
+{
+    class NoCMessage;
+
+    /*!
+     * \class coyote::PacketDeliveryQueue
+     * \brief The packets in flight in the NoC models that compute their latency on injection, waiting to be delivered.
+     *
+     * Each destination (a tile or a memory CPU of a network) has its own FIFO ring buffer of packets, and a min-heap
+     * holds the cycle in which the packet at the front of each non-empty ring is due. Delivering the packets of a cycle
+     * only visits the destinations that have a packet due, instead of every destination of every network. A destination
+     * delivers at most one packet per cycle, and a packet that is due waits for the ones queued before it.
+     */
+    class PacketDeliveryQueue
+    {
+        public:
+            static constexpr uint64_t NO_PENDING_DELIVERY=std::numeric_limits<uint64_t>::max(); //! There are no packets to deliver
+
+            /*!
+             * \brief Constructor for PacketDeliveryQueue
+             * \param networks The number of networks
+             * \param tiles The number of tiles
+             * \param memory_cpus The number of memory CPUs
+             */
+            PacketDeliveryQueue(uint8_t networks, uint16_t tiles, uint16_t memory_cpus) :
+                tiles_(tiles),
+                destinations_per_network_(tiles+memory_cpus),
+                rings_(networks*destinations_per_network_),
+                heap_()
+            {}
+
+            /*!
+             * \brief Queue a packet
+             * \param network The network of the packet
+             * \param to_memory_cpu Whether the destination is a memory CPU or a tile
+             * \param destination The destination tile or memory CPU
+             * \param mess The packet
+             * \param cycle The cycle from which the packet can be delivered
+             */
+            void push(uint8_t network, bool to_memory_cpu, uint16_t destination, const std::shared_ptr<NoCMessage>& mess, uint64_t cycle)
+            {
+                uint32_t slot=network*destinations_per_network_+(to_memory_cpu ? tiles_+destination : destination);
+                Ring& r=rings_[slot];
+                if(r.count==r.packets.size())
+                {
+                    r.grow();
+                }
+                r.packets[(r.head+r.count) & (r.packets.size()-1)]=Packet{mess, cycle};
+                r.count++;
+                if(r.count==1)
+                {
+                    heap_.push(Entry{cycle, slot});
+                }
+            }
+
+            /*!
+             * \brief Get the destinations that have a packet due, removing them from the heap
+             * \param cycle The current cycle
+             * \param slots The destinations, in order of network, tiles before memory CPUs and index. Each one must be
+             * popped or rescheduled afterwards
+             */
+            void getDue(uint64_t cycle, std::vector<uint32_t>& slots)
+            {
+                slots.clear();
+                while(!heap_.empty() && heap_.top().cycle<=cycle)
+                {
+                    slots.push_back(heap_.top().slot);
+                    heap_.pop();
+                }
+                std::sort(slots.begin(), slots.end());
+            }
+
+            /*!
+             * \brief Get the packet at the front of a destination
+             * \param slot The destination
+             * \return The packet
+             */
+            const std::shared_ptr<NoCMessage>& front(uint32_t slot) const
+            {
+                return rings_[slot].packets[rings_[slot].head].mess;
+            }
+
+            /*!
+             * \brief Remove the packet at the front of a destination. The next one may be delivered from the next cycle
+             * \param slot The destination
+             * \param cycle The current cycle
+             */
+            void pop(uint32_t slot, uint64_t cycle)
+            {
+                Ring& r=rings_[slot];
+                r.packets[r.head].mess.reset();
+                r.head=(r.head+1) & (r.packets.size()-1);
+                r.count--;
+                if(r.count>0)
+                {
+                    heap_.push(Entry{std::max(r.packets[r.head].cycle, cycle+1), slot});
+                }
+            }
+
+            /*!
+             * \brief Retry the delivery of the packet at the front of a destination in the next cycle
+             * \param slot The destination
+             * \param cycle The current cycle
+             */
+            void retry(uint32_t slot, uint64_t cycle)
+            {
+                heap_.push(Entry{cycle+1, slot});
+            }
+
+            /*!
+             * \brief Get the network of a destination
+             * \param slot The destination
+             * \return The network
+             */
+            uint8_t getNetwork(uint32_t slot) const
+            {
+                return slot/destinations_per_network_;
+            }
+
+            /*!
+             * \brief Check if a destination is a memory CPU
+             * \param slot The destination
+             * \return true if it is a memory CPU, false if it is a tile
+             */
+            bool isMemoryCPU(uint32_t slot) const
+            {
+                return slot%destinations_per_network_>=tiles_;
+            }
+
+            /*!
+             * \brief Get the index of the tile or memory CPU of a destination
+             * \param slot The destination
+             * \return The index
+             */
+            uint16_t getDestination(uint32_t slot) const
+            {
+                uint16_t d=slot%destinations_per_network_;
+                return d>=tiles_ ? d-tiles_ : d;
+            }
+
+            /*!
+             * \brief Get the next cycle in which a packet is due
+             * \return The cycle, or NO_PENDING_DELIVERY if there are no packets
+             */
+            uint64_t getNextCycle() const
+            {
+                return heap_.empty() ? NO_PENDING_DELIVERY : heap_.top().cycle;
+            }
+
+        private:
+            struct Packet
+            {
+                std::shared_ptr<NoCMessage> mess;
+                uint64_t cycle;
+            };
+
+            struct Ring
+            {
+                std::vector<Packet> packets;    //! The capacity is always a power of two
+                size_t head=0;
+                size_t count=0;
+
+                /*!
+                 * \brief Double the capacity of the ring, keeping the packets in order
+                 */
+                void grow()
+                {
+                    std::vector<Packet> larger(packets.empty() ? 4 : 2*packets.size());
+                    for(size_t i=0; i<count; i++)
+                    {
+                        larger[i]=std::move(packets[(head+i) & (packets.size()-1)]);
+                    }
+                    packets.swap(larger);
+                    head=0;
+                }
+            };
+
+            struct Entry
+            {
+                uint64_t cycle;
+                uint32_t slot;
+
+                bool operator>(const Entry& e) const
+                {
+                    return cycle>e.cycle || (cycle==e.cycle && slot>e.slot);
+                }
+            };
+
+            uint16_t tiles_;
+            uint32_t destinations_per_network_;
+            std::vector<Ring> rings_;                                                       //! Indexed by network and destination
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;      //! One entry per non-empty ring
+    };
+}
+#endif
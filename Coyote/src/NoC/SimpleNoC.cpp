@@ -37,11 +37,14 @@ namespace coyote
     SimpleNoC::SimpleNoC(sparta::TreeNode *node, const SimpleNoCParameterSet *params) :
         NoC(node, params),
         latency_per_hop_(params->latency_per_hop),
-        dst_count_(y_size_, vector<vector<uint64_t>>(x_size_, vector<uint64_t>(noc_networks_.size(), 0))),
-        src_count_(y_size_, vector<vector<uint64_t>>(x_size_, vector<uint64_t>(noc_networks_.size(), 0))),
-        dst_src_count_(y_size_, vector<vector<vector<vector<uint64_t>>>>(x_size_, vector<vector<vector<uint64_t>>>(
-                   y_size_, vector<vector<uint64_t>>(x_size_, vector<uint64_t>(noc_networks_.size(), 0))))),
-        pkt_count_prefix_(params->packet_count_file_prefix),
+        topology_(Topology::MESH),
+        concentration_x_(1),
+        concentration_y_(1),
+        max_hop_count_(0),
+        network_width_(params->network_width),
+        pkt_count_(static_cast<size_t>(size_) * size_ * noc_networks_.size(), 0),
+        pkt_count_writer_(new TrafficMatrixWriter(params->packet_count_file_prefix + "matrix.bin", x_size_, y_size_,
+                                                  noc_networks_, params->flush_packet_count_each_period)),
         pkt_count_period_(params->packet_count_periodicity),
         pkt_count_stage_(0),
         pkt_count_flush_(params->flush_packet_count_each_period)
@@ -62,6 +65,66 @@ namespace coyote
         sparta_assert(mcpus_coordinates_.size() == num_memory_cpus_);
         sparta_assert(tiles_coordinates_.size() == num_tiles_);
 
+        // Topology
+        const std::string topology = params->topology;
+        if(topology == "mesh")
+        {
+            topology_ = Topology::MESH;
+            max_hop_count_ = x_size_ + y_size_ - 1;
+        }
+        else if(topology == "torus")
+        {
+            topology_ = Topology::TORUS;
+            max_hop_count_ = x_size_/2 + y_size_/2 + DESTINATION_ROUTER;
+        }
+        else if(topology == "ring")
+        {
+            // The nodes are connected in the order of their index in the mesh (row by row)
+            topology_ = Topology::RING;
+            max_hop_count_ = size_/2 + DESTINATION_ROUTER;
+        }
+        else if(topology == "cmesh")
+        {
+            topology_ = Topology::CMESH;
+            sparta_assert(params->concentration.isVector() && params->concentration.getNumValues() == 2,
+                "The top.cpu.noc.params.concentration must be a vector with the concentration in X and Y");
+            concentration_x_ = params->concentration.getValue()[0];
+            concentration_y_ = params->concentration.getValue()[1];
+            sparta_assert(concentration_x_ > 0 && concentration_y_ > 0 &&
+                          x_size_ % concentration_x_ == 0 && y_size_ % concentration_y_ == 0,
+                "The concentration must divide the size of the mesh in each dimension");
+            max_hop_count_ = x_size_/concentration_x_ + y_size_/concentration_y_ - 1;
+        }
+        else
+            sparta_assert(false, "The supported topologies are: mesh, torus, ring and cmesh. Not: " << topology);
+
+        // Link statistics on the routers of the topology. Only they need the width of the networks
+        if(!link_stats_prefix_.empty())
+        {
+            sparta_assert(params->network_width.isVector(), "The top.cpu.noc.params.network_width must be a vector");
+            sparta_assert(params->network_width.getNumValues() == noc_networks_.size(),
+                "The number of elements in top.cpu.noc.params.network_width must be: " << noc_networks_.size());
+        }
+        switch(topology_)
+        {
+            case Topology::MESH:
+                enableLinkStatistics_({x_size_, y_size_}, false);
+                break;
+            case Topology::TORUS:
+                enableLinkStatistics_({x_size_, y_size_}, true);
+                break;
+            case Topology::RING:
+                enableLinkStatistics_({size_}, true);
+                break;
+            case Topology::CMESH:
+                enableLinkStatistics_({static_cast<uint16_t>(x_size_/concentration_x_), static_cast<uint16_t>(y_size_/concentration_y_)}, false);
+                break;
+        }
+
+        const std::string booksim_configuration_output = params->booksim_configuration_output;
+        if(!booksim_configuration_output.empty())
+            writeBookSimConfiguration_(booksim_configuration_output);
+
         // Statistics
         for(auto network : noc_networks_)
         {
@@ -84,9 +147,10 @@ namespace coyote
 
     SimpleNoC::~SimpleNoC()
     {
-        // Write the latest statistics file
+        // Write the latest statistics and wait for the pending ones
         pkt_count_stage_--;
         writePacketCountMatrix_();
+        pkt_count_writer_.reset();
         debug_logger_ << getContainer()->getLocation() << ": " << std::endl;
     }
 
@@ -103,14 +167,13 @@ namespace coyote
             // VAS -> VAS messages
             case NoCMessageType::REMOTE_L2_REQUEST:
             case NoCMessageType::REMOTE_L2_ACK:
-                hop_count = abs(tiles_coordinates_[mess->getDstPort()].first - tiles_coordinates_[mess->getSrcPort()].first) + 
-                            abs(tiles_coordinates_[mess->getDstPort()].second - tiles_coordinates_[mess->getSrcPort()].second) +
-                            DESTINATION_ROUTER;
-                dst_count_[tiles_coordinates_[mess->getDstPort()].second][tiles_coordinates_[mess->getDstPort()].first][mess->getNoCNetwork()]++; // [y][x][NoC]
-                src_count_[tiles_coordinates_[mess->getSrcPort()].second][tiles_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++;
-                dst_src_count_[tiles_coordinates_[mess->getDstPort()].second][tiles_coordinates_[mess->getDstPort()].first][tiles_coordinates_[mess->getSrcPort()].second][tiles_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++; //dst[y][x]src[y][x][NoC]
+            case NoCMessageType::COHERENCE_REQUEST:
+            case NoCMessageType::COHERENCE_INVALIDATE:
+            case NoCMessageType::COHERENCE_FORWARD:
+            case NoCMessageType::COHERENCE_ACK:
+                hop_count = accountPacket_(tiles_coordinates_[mess->getSrcPort()], tiles_coordinates_[mess->getDstPort()], mess);
                 // Latency: Injection + Link traversal + hops * latency_per_hop (RC - VA - SA - ST + output_link)
-                vas_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_));
+                delivery_queue_.push(mess->getNoCNetwork(), false, mess->getDstPort(), mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_);
                 break;
 
             // VAS -> MEM messages
@@ -120,19 +183,14 @@ namespace coyote
             case NoCMessageType::MCPU_REQUEST:
             case NoCMessageType::SCRATCHPAD_ACK:
             case NoCMessageType::SCRATCHPAD_DATA_REPLY:
-                hop_count = abs(mcpus_coordinates_[mess->getDstPort()].first - tiles_coordinates_[mess->getSrcPort()].first) + 
-                            abs(mcpus_coordinates_[mess->getDstPort()].second - tiles_coordinates_[mess->getSrcPort()].second) + 
-                            DESTINATION_ROUTER;
-                dst_count_[mcpus_coordinates_[mess->getDstPort()].second][mcpus_coordinates_[mess->getDstPort()].first][mess->getNoCNetwork()]++; // [y][x][NoC]
-                src_count_[tiles_coordinates_[mess->getSrcPort()].second][tiles_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++;
-                dst_src_count_[mcpus_coordinates_[mess->getDstPort()].second][mcpus_coordinates_[mess->getDstPort()].first][tiles_coordinates_[mess->getSrcPort()].second][tiles_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++; //dst[y][x]src[y][x][NoC]
-                mem_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_));
+                hop_count = accountPacket_(tiles_coordinates_[mess->getSrcPort()], mcpus_coordinates_[mess->getDstPort()], mess);
+                delivery_queue_.push(mess->getNoCNetwork(), true, mess->getDstPort(), mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_);
                 break;
 
             default:
                 sparta_assert(false);
         }
-        sparta_assert(hop_count >= 0 && hop_count <= x_size_ + y_size_ - 1);
+        sparta_assert(hop_count >= 0 && hop_count <= max_hop_count_);
         // Hop count for each network
         hop_count_[mess->getNoCNetwork()] += hop_count;
     }
@@ -149,158 +207,178 @@ namespace coyote
             case NoCMessageType::MEMORY_ACK:
             case NoCMessageType::MCPU_REQUEST:
             case NoCMessageType::SCRATCHPAD_COMMAND:
-                hop_count = abs(tiles_coordinates_[mess->getDstPort()].first - mcpus_coordinates_[mess->getSrcPort()].first) + 
-                            abs(tiles_coordinates_[mess->getDstPort()].second - mcpus_coordinates_[mess->getSrcPort()].second) +
-                            DESTINATION_ROUTER;
-                dst_count_[tiles_coordinates_[mess->getDstPort()].second][tiles_coordinates_[mess->getDstPort()].first][mess->getNoCNetwork()]++; // [y][x][NoC]
-                src_count_[mcpus_coordinates_[mess->getSrcPort()].second][mcpus_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++;
-                dst_src_count_[tiles_coordinates_[mess->getDstPort()].second][tiles_coordinates_[mess->getDstPort()].first][mcpus_coordinates_[mess->getSrcPort()].second][mcpus_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++; //dst[y][x]src[y][x][NoC]
-                vas_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_));
+                hop_count = accountPacket_(mcpus_coordinates_[mess->getSrcPort()], tiles_coordinates_[mess->getDstPort()], mess);
+                delivery_queue_.push(mess->getNoCNetwork(), false, mess->getDstPort(), mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_);
                 break;
                 
             // MEM -> MEM messages
             case NoCMessageType::MEM_TILE_REQUEST:
             case NoCMessageType::MEM_TILE_REPLY:
-                hop_count = abs(mcpus_coordinates_[mess->getDstPort()].first - mcpus_coordinates_[mess->getSrcPort()].first) + 
-                            abs(mcpus_coordinates_[mess->getDstPort()].second - mcpus_coordinates_[mess->getSrcPort()].second) +
-                            DESTINATION_ROUTER;
-                dst_count_[mcpus_coordinates_[mess->getDstPort()].second][mcpus_coordinates_[mess->getDstPort()].first][mess->getNoCNetwork()]++; // [y][x][NoC]
-                src_count_[mcpus_coordinates_[mess->getSrcPort()].second][mcpus_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++;
-                dst_src_count_[mcpus_coordinates_[mess->getDstPort()].second][mcpus_coordinates_[mess->getDstPort()].first][mcpus_coordinates_[mess->getSrcPort()].second][mcpus_coordinates_[mess->getSrcPort()].first][mess->getNoCNetwork()]++; //dst[y][x]src[y][x][NoC]
-                mem_queue_.at(mess->getNoCNetwork()).at(mess->getDstPort()).push_back(std::make_pair(mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_));
+                hop_count = accountPacket_(mcpus_coordinates_[mess->getSrcPort()], mcpus_coordinates_[mess->getDstPort()], mess);
+                delivery_queue_.push(mess->getNoCNetwork(), true, mess->getDstPort(), mess, getClock()->currentCycle() + INJECTION + LINK_TRAVERSAL + hop_count*latency_per_hop_);
                 break;
             default:
                 sparta_assert(false);
         }
-        sparta_assert(hop_count >= 0 && hop_count <= x_size_ + y_size_ - 1);
+        sparta_assert(hop_count >= 0 && hop_count <= max_hop_count_);
         // Hop count for each network
         hop_count_[mess->getNoCNetwork()] += hop_count;
     }
 
-    void SimpleNoC::writePacketCountMatrix_()
+    uint16_t SimpleNoC::getRouter_(const pair<uint16_t, uint16_t>& node) const
     {
-        if(getClock()->currentCycle() < pkt_count_stage_ * pkt_count_period_)
-            return;
-
-        pkt_count_stage_++;
+        if(topology_ == Topology::CMESH)
+            return (node.second/concentration_y_) * (x_size_/concentration_x_) + node.first/concentration_x_;
+        return node.second * x_size_ + node.first;
+    }
 
-        std::vector<std::ofstream> dst_file;
-        std::ofstream dst_file_aggregated;
-        std::vector<std::ofstream> src_file;
-        std::ofstream src_file_aggregated;
-        std::vector<std::ofstream> dst_src_file;
-        std::ofstream dst_src_file_aggregated;
+    int SimpleNoC::accountPacket_(const pair<uint16_t, uint16_t>& src, const pair<uint16_t, uint16_t>& dst, const std::shared_ptr<NoCMessage> & mess)
+    {
+        uint8_t network = mess->getNoCNetwork();
+        int hop_count = -1;
+        int distance_x = abs(dst.first - src.first);
+        int distance_y = abs(dst.second - src.second);
+        switch(topology_)
+        {
+            case Topology::MESH:
+                hop_count = distance_x + distance_y + DESTINATION_ROUTER;
+                break;
 
-        dst_file.resize(noc_networks_.size());
-        src_file.resize(noc_networks_.size());
-        dst_src_file.resize(noc_networks_.size());
+            case Topology::TORUS:
+                // The wraparound links are taken when they are shorter
+                hop_count = std::min(distance_x, x_size_ - distance_x) + std::min(distance_y, y_size_ - distance_y) + DESTINATION_ROUTER;
+                break;
 
-        // DST files
-        for(auto network : noc_networks_)
-        {
-            dst_file[getNetworkFromString(network)].open(pkt_count_prefix_ + "dst_" + network + "_" + std::to_string(getClock()->currentCycle()) + ".csv");
-        }
-        dst_file_aggregated.open(pkt_count_prefix_ + "dst_aggregated_" + std::to_string(getClock()->currentCycle()) + ".csv");
-        uint64_t aggregated;
-        for(int y=0; y < y_size_; ++y)
-        {
-            for(int x=0; x < x_size_; ++x)
+            case Topology::RING:
             {
-                aggregated = 0;
-                for(auto network : noc_networks_)
-                {
-                    dst_file[getNetworkFromString(network)] << dst_count_[y][x][getNetworkFromString(network)] << ";";
-                    aggregated += dst_count_[y][x][getNetworkFromString(network)];
-                    if(pkt_count_flush_)
-                    {
-                        dst_count_[y][x][getNetworkFromString(network)] = 0;
-                    }
-                }
-                dst_file_aggregated << aggregated << ";";
+                int distance = abs((dst.second * x_size_ + dst.first) - (src.second * x_size_ + src.first));
+                hop_count = std::min(distance, size_ - distance) + DESTINATION_ROUTER;
+                break;
             }
-            for(auto network : noc_networks_)
-                dst_file[getNetworkFromString(network)] << "\n";
-            dst_file_aggregated << "\n";
-        }
-        for(auto network : noc_networks_)
-        {
-            dst_file[getNetworkFromString(network)].close();
-        }
-        dst_file_aggregated.close();
 
-        // SRC files
-        for(auto network : noc_networks_)
-        {
-            src_file[getNetworkFromString(network)].open(pkt_count_prefix_ + "src_" + network + "_" + std::to_string(getClock()->currentCycle()) + ".csv");
-        }
-        src_file_aggregated.open(pkt_count_prefix_ + "src_aggregated_" + std::to_string(getClock()->currentCycle()) + ".csv");
-        for(int y=0; y < y_size_; ++y)
-        {
-            for(int x=0; x < x_size_; ++x)
-            {
-                aggregated = 0;
-                for(auto network : noc_networks_)
-                {
-                    src_file[getNetworkFromString(network)] << src_count_[y][x][getNetworkFromString(network)] << ";";
-                    aggregated += src_count_[y][x][getNetworkFromString(network)];
-                    if(pkt_count_flush_)
-                    {
-                        src_count_[y][x][getNetworkFromString(network)] = 0;
-                    }
-                }
-                src_file_aggregated << aggregated << ";";
-            }
-            for(auto network : noc_networks_)
-            {
-                src_file[getNetworkFromString(network)] << "\n";
-            }
-            src_file_aggregated << "\n";
+            case Topology::CMESH:
+                // Nodes connected to the same router only cross that router
+                hop_count = abs(dst.first/concentration_x_ - src.first/concentration_x_) +
+                            abs(dst.second/concentration_y_ - src.second/concentration_y_) +
+                            DESTINATION_ROUTER;
+                break;
         }
-        for(auto network : noc_networks_)
+        // The packet counts are kept by node, independently of the topology. The counts by source and destination are derived from them
+        pkt_count_[getPacketCountIndex_(dst, src, network)]++; //dst[y][x]src[y][x][NoC]
+        if(link_stats_)
         {
-            src_file[getNetworkFromString(network)].close();
+            // Without contention, the flits of the packet stay latency_per_hop cycles in each router of the route
+            uint16_t flits = (uint16_t) ceil(1.0*mess->getSize()/network_width_[network]); // message size and network_width are in bits
+            uint64_t current_cycle = getClock()->currentCycle();
+            link_stats_->addPacket(network, getRouter_(src), getRouter_(dst), flits, current_cycle);
+            link_stats_->addRouterOccupancy(network, getRouter_(src), getRouter_(dst), 1.0 * flits * latency_per_hop_ * hop_count, current_cycle);
         }
-        src_file_aggregated.close();
+        return hop_count;
+    }
 
-        // DST_SRC files
-        for(auto network : noc_networks_)
+    void SimpleNoC::writeBookSimConfiguration_(const std::string& filename)
+    {
+        std::ofstream cfg(filename);
+        sparta_assert(cfg.is_open(), "Could not open the BookSim configuration file: " << filename);
+
+        // Tori need two VCs per class to break the cyclic dependencies with a dateline
+        // BookSim appends the topology to the routing function, so dim_order selects dim_order_torus on a torus
+        uint16_t vcs_per_class = 1;
+        cfg << "// Topology\n";
+        switch(topology_)
         {
-            dst_src_file[getNetworkFromString(network)].open(pkt_count_prefix_ + "dst_src_" + network + "_" + std::to_string(getClock()->currentCycle()) + ".csv");
+            case Topology::MESH:
+                cfg << "topology = cmesh;\n";
+                cfg << "k = {" << x_size_ << "," << y_size_ << "};\n";
+                cfg << "n = 2;\n";
+                cfg << "c = {1,1};\n";
+                cfg << "\n// Routing\nrouting_function = dim_order;\n";
+                break;
+
+            case Topology::CMESH:
+                cfg << "topology = cmesh;\n";
+                cfg << "k = {" << x_size_/concentration_x_ << "," << y_size_/concentration_y_ << "};\n";
+                cfg << "n = 2;\n";
+                cfg << "c = {" << concentration_x_ << "," << concentration_y_ << "};\n";
+                cfg << "\n// Routing\nrouting_function = dim_order;\n";
+                break;
+
+            case Topology::TORUS:
+                sparta_assert(x_size_ == y_size_, "BookSim only supports tori with the same size in every dimension");
+                cfg << "topology = torus;\n";
+                cfg << "k = " << x_size_ << ";\n";
+                cfg << "n = 2;\n";
+                cfg << "\n// Routing\nrouting_function = dim_order;\n";
+                vcs_per_class = 2;
+                break;
+
+            case Topology::RING:
+                cfg << "topology = torus;\n";
+                cfg << "k = " << size_ << ";\n";
+                cfg << "n = 1;\n";
+                cfg << "\n// Routing\nrouting_function = dim_order;\n";
+                vcs_per_class = 2;
+                break;
         }
-        dst_src_file_aggregated.open(pkt_count_prefix_ + "dst_src_aggregated_" + std::to_string(getClock()->currentCycle()) + ".csv");
-        for(int dsty=0; dsty < y_size_; ++dsty)
+
+        // The baseline router of the detailed model
+        cfg << "\n// Router configuration\n";
+        cfg << "router = iq;\n";
+        cfg << "vc_buf_size = 16;\n";
+        cfg << "injection_queue_size = 128;\n";
+        cfg << "ejection_queue_size = 4;\n";
+        cfg << "sw_allocator = separable_input_first;\n";
+        cfg << "\n// Delays\n";
+        cfg << "credit_delay = 1;\n";
+        cfg << "routing_delay = 0;\n";
+        cfg << "vc_alloc_delay = 1;\n";
+        cfg << "sw_alloc_delay = 1;\n";
+        cfg << "st_prepare_delay = 0;\n";
+        cfg << "st_final_delay = 1;\n";
+
+        // One class for each priority used by the messages
+        uint16_t classes = max_class_used_ + 1;
+        cfg << "\n// Traffic\n";
+        cfg << "classes = " << classes << ";\n";
+        if(classes > 1)
         {
-            for(int dstx=0; dstx < x_size_; ++dstx)
-            {
-                for(int srcy=0; srcy < y_size_; ++srcy)
-                {
-                    for(int srcx=0; srcx < x_size_; ++srcx)
-                    {
-                        aggregated = 0;
-                        for(auto network : noc_networks_)
-                        {
-                            dst_src_file[getNetworkFromString(network)] << dst_src_count_[dsty][dstx][srcy][srcx][getNetworkFromString(network)] << ";";
-                            aggregated += dst_src_count_[dsty][dstx][srcy][srcx][getNetworkFromString(network)];
-                            if(pkt_count_flush_)
-                            {
-                                dst_src_count_[dsty][dstx][srcy][srcx][getNetworkFromString(network)] = 0;
-                            }
-                        }
-                        dst_src_file_aggregated << aggregated << ";";
-                    }
-                }
-                for(auto network : noc_networks_)
-                {
-                    dst_src_file[getNetworkFromString(network)] << "\n";
-                }
-                dst_src_file_aggregated << "\n";
-            }
+            cfg << "priority = class;\n";
+            cfg << "class_priority = {";
+            for(uint16_t c=0; c < classes; ++c)
+                cfg << (c ? "," : "") << c;
+            cfg << "};\n";
         }
-        for(auto network : noc_networks_)
+        cfg << "injection_queues = " << classes << ";\n";
+
+        cfg << "\n// VCs management\n";
+        cfg << "num_vcs = " << classes * vcs_per_class << ";\n";
+        if(classes * vcs_per_class > 1)
         {
-            dst_src_file[getNetworkFromString(network)].close();
+            cfg << "start_vc = {";
+            for(uint16_t c=0; c < classes; ++c)
+                cfg << (c ? "," : "") << c * vcs_per_class;
+            cfg << "};\n";
+            cfg << "end_vc = {";
+            for(uint16_t c=0; c < classes; ++c)
+                cfg << (c ? "," : "") << (c + 1) * vcs_per_class - 1;
+            cfg << "};\n";
         }
-        dst_src_file_aggregated.close();
+
+        cfg << "\n// Simulator\n";
+        cfg << "deadlock_warn_timeout = 1000;\n";
+        cfg.close();
+    }
+
+    void SimpleNoC::writePacketCountMatrix_()
+    {
+        if(getClock()->currentCycle() < pkt_count_stage_ * pkt_count_period_)
+            return;
+
+        pkt_count_stage_++;
+
+        pkt_count_writer_->append(getClock()->currentCycle(), pkt_count_);
+        if(pkt_count_flush_)
+            std::fill(pkt_count_.begin(), pkt_count_.end(), 0);
     }
 
 } // coyote
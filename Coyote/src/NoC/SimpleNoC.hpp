@@ -21,7 +21,9 @@
 #ifndef __SIMPLE_NOC_H__
 #define __SIMPLE_NOC_H__
 
+#include <memory>
 #include "NoC.hpp"
+#include "TrafficMatrixWriter.hpp"
 
 using std::vector;
 using std::string;
@@ -35,7 +37,9 @@ namespace coyote
          * \class SimpleNoC
          * \brief Simple model of the NoC with a mesh topology which calculates the average hop count and generates traffic maps
          * 
-         * It models a MESH with a variable location of the MCPUs and DOR to calculate the hop count
+         * It models a MESH with a variable location of the MCPUs and DOR to calculate the hop count. The hop count may also be
+         * calculated for a TORUS (wraparound links in both dimensions), a bidirectional RING that connects the nodes in order
+         * or a concentrated mesh (CMESH) in which each router connects a block of concentration nodes
          */
     public:
         /*!
@@ -51,9 +55,12 @@ namespace coyote
             {
             }
             PARAMETER(uint16_t, latency_per_hop, 4, "The latency for each hop (router + output_link)")
-            PARAMETER(std::string, packet_count_file_prefix, "packet_count_", "The prefix of SRC and DST packet count filenames")
+            PARAMETER(std::string, packet_count_file_prefix, "packet_count_", "The prefix of the SRC and DST packet count matrix file (<prefix>matrix.bin)")
             PARAMETER(uint32_t, packet_count_periodicity, 100000, "SRC and DST packet count statistics write periodicity")
             PARAMETER(bool, flush_packet_count_each_period, false, "Flush the packet count statistics or accumulate them")
+            PARAMETER(std::string, topology, "mesh", "The topology of the network (mesh, torus, ring, cmesh)")
+            PARAMETER(vector<uint16_t>, concentration, vector<uint16_t>({2,2}), "The number of nodes connected to each router in X and Y for the cmesh topology")
+            PARAMETER(std::string, booksim_configuration_output, "", "If not empty, the file in which a BookSim configuration with the same topology is written for the detailed model")
         };
 
         /*!
@@ -86,22 +93,67 @@ namespace coyote
         void handleMessageFromMemoryCPU_(const std::shared_ptr<NoCMessage> & mess) override;
 
         /*!
-         * \brief Write the SRC and DST packet count matrix to a file each stats_periodicity_ cycles
+         * \brief Append the SRC and DST packet count matrix to the matrix file each stats_periodicity_ cycles
          * 
          */
         void writePacketCountMatrix_();
 
+        /*!
+         * \brief Get the position of a count in the packet count matrix
+         * \param dst The coordinates (X, Y) of the destination
+         * \param src The coordinates (X, Y) of the source
+         * \param network The NoC network
+         * \return The index in pkt_count_
+         */
+        size_t getPacketCountIndex_(const pair<uint16_t, uint16_t>& dst, const pair<uint16_t, uint16_t>& src, uint8_t network) const
+        {
+            return ((static_cast<size_t>(dst.second * x_size_ + dst.first) * size_) + src.second * x_size_ + src.first) * noc_networks_.size() + network;
+        }
+
+        /*!
+         * \brief Calculate the hop count of a packet in the configured topology and account it in the packet count matrices and link statistics
+         * \param src The coordinates (X, Y) of the source
+         * \param dst The coordinates (X, Y) of the destination
+         * \param mess The message
+         * \return The number of crossed routers
+         */
+        int accountPacket_(const pair<uint16_t, uint16_t>& src, const pair<uint16_t, uint16_t>& dst, const std::shared_ptr<NoCMessage> & mess);
+
+        /*!
+         * \brief Get the router a node is connected to in the configured topology
+         * \param node The coordinates (X, Y) of the node
+         * \return The index of the router
+         */
+        uint16_t getRouter_(const pair<uint16_t, uint16_t>& node) const;
+
+        /*!
+         * \brief Write a BookSim configuration that models the configured topology
+         * \param filename The name of the file
+         */
+        void writeBookSimConfiguration_(const std::string& filename);
+
+        //! The supported topologies
+        enum class Topology
+        {
+            MESH,
+            TORUS,
+            RING,
+            CMESH
+        };
+
         uint16_t                            latency_per_hop_;   //! The latency for each hop
+        Topology                            topology_;          //! The topology used to calculate the hop count
+        uint16_t                            concentration_x_;   //! The number of nodes per router in X (cmesh)
+        uint16_t                            concentration_y_;   //! The number of nodes per router in Y (cmesh)
+        int                                 max_hop_count_;     //! The maximum hop count in the topology
+        vector<uint16_t>                    network_width_;     //! Physical channel width (bits)
         vector<pair<uint16_t, uint16_t>>    mcpus_coordinates_; //! The coordinates of MCPUs
         vector<pair<uint16_t, uint16_t>>    tiles_coordinates_; //! The coordinates of TILEs
         std::vector<sparta::Counter>        hop_count_;         //! Tracks the hop count for each NoC network
         std::vector<sparta::StatisticDef>   average_hop_count_; //! The average hop count for each NoC (counts crossed routers)
-        //[y][x][network]
-        vector<vector<vector<uint64_t>>>    dst_count_;         //! Accumulates the number of packets to each destination by NoC network
-        vector<vector<vector<uint64_t>>>    src_count_;         //! Accumulates the number of packets from each source by NoC network
         //DST[y][x]SRC[y][x][network]
-        vector<vector<vector<vector<vector<uint64_t>>>>> dst_src_count_; //! Accumulates the number of packets from each src to each dst by NoC network
-        std::string                         pkt_count_prefix_;  //! The filename prefix for SRC and DST packet count
+        vector<uint64_t>                    pkt_count_;         //! Accumulates the number of packets from each src to each dst by NoC network
+        std::unique_ptr<TrafficMatrixWriter> pkt_count_writer_; //! Writes the packet count matrix each period off the simulation thread
         uint32_t                            pkt_count_period_;  //! The number of cycles to write packet count statistics
         uint16_t                            pkt_count_stage_;   //! The current stage of writting statistics
         bool                                pkt_count_flush_;    //! Flush or accumulate packet counts
@@ -0,0 +1,112 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "TrafficMatrixWriter.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace coyote
+{
+    constexpr char TrafficMatrixWriter::MAGIC[8];
+
+    namespace
+    {
+        template<typename T>
+        void encodeValue(std::vector<char>& bytes, T value)
+        {
+            // The values are stored little-endian independently of the host
+            for(size_t b=0; b < sizeof(T); ++b)
+                bytes.push_back(static_cast<char>((value >> (8 * b)) & 0xFF));
+        }
+    }
+
+    TrafficMatrixWriter::TrafficMatrixWriter(const std::string& filename, uint16_t x_size, uint16_t y_size,
+                                             const std::vector<std::string>& networks, bool flush) :
+        file_(filename, std::ios::binary | std::ios::trunc),
+        slice_size_(static_cast<size_t>(x_size) * y_size * x_size * y_size * networks.size()),
+        done_(false)
+    {
+        sparta_assert(file_.is_open(), "Could not open the traffic matrix file: " << filename);
+        std::vector<char> header(MAGIC, MAGIC + sizeof(MAGIC));
+        encodeValue<uint32_t>(header, VERSION);
+        encodeValue<uint16_t>(header, x_size);
+        encodeValue<uint16_t>(header, y_size);
+        encodeValue<uint16_t>(header, networks.size());
+        encodeValue<uint8_t>(header, flush);
+        for(const auto& network : networks)
+        {
+            encodeValue<uint16_t>(header, network.size());
+            header.insert(header.end(), network.begin(), network.end());
+        }
+        file_.write(header.data(), header.size());
+        thread_=std::thread(&TrafficMatrixWriter::write_, this);
+    }
+
+    TrafficMatrixWriter::~TrafficMatrixWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_=true;
+        }
+        pending_cv_.notify_one();
+        thread_.join();
+        file_.close();
+    }
+
+    void TrafficMatrixWriter::append(uint64_t cycle, const std::vector<uint64_t>& counts)
+    {
+        sparta_assert(counts.size() == slice_size_, "The slice has " << counts.size() << " counts instead of " << slice_size_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<uint64_t> buffer;
+            if(!free_buffers_.empty())
+            {
+                buffer=std::move(free_buffers_.back());
+                free_buffers_.pop_back();
+            }
+            buffer.assign(counts.begin(), counts.end());
+            pending_.emplace_back(cycle, std::move(buffer));
+        }
+        pending_cv_.notify_one();
+    }
+
+    void TrafficMatrixWriter::write_()
+    {
+        std::vector<char> bytes;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while(true)
+        {
+            pending_cv_.wait(lock, [this]{return done_ || !pending_.empty();});
+            if(pending_.empty())
+                return; // done_ and every slice written
+
+            std::pair<uint64_t, std::vector<uint64_t>> slice=std::move(pending_.front());
+            pending_.pop_front();
+            lock.unlock();
+
+            bytes.clear();
+            encodeValue<uint64_t>(bytes, slice.first);
+            for(uint64_t count : slice.second)
+                encodeValue<uint64_t>(bytes, count);
+            file_.write(bytes.data(), bytes.size());
+
+            lock.lock();
+            free_buffers_.push_back(std::move(slice.second));
+        }
+    }
+}
@@ -0,0 +1,99 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __TRAFFIC_MATRIX_WRITER_H__
+#define __TRAFFIC_MATRIX_WRITER_H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace coyote
+{
+    /*!
+     * \class coyote::TrafficMatrixWriter
+     * \brief Appends time slices of the source-destination packet count matrix of the NoC to a binary file from a background thread.
+     *
+     * The file starts with a header:
+     *   - char[8]  magic "COYNOCTM"
+     *   - uint32   version
+     *   - uint16   X size, Y size and number of networks
+     *   - uint8    1 if the counts are flushed each period, 0 if they are accumulated
+     *   - for each network: uint16 length of the name followed by the name
+     *
+     * It is followed by one slice per period: the uint64 cycle and the uint64 packet counts indexed by
+     * [destination node][source node][network], with node = y * X size + x. All the values are little-endian.
+     * The counts by source and by destination are the sums of the rows and columns of the matrix.
+     * The traffic2csv.py script converts the file to the packet count CSV files.
+     */
+    class TrafficMatrixWriter
+    {
+        public:
+            /*!
+             * \brief Constructor for TrafficMatrixWriter. Writes the header and starts the writing thread
+             * \param filename The name of the file
+             * \param x_size The size of the X dimension of the NoC
+             * \param y_size The size of the Y dimension of the NoC
+             * \param networks The names of the NoC networks
+             * \param flush Whether the counts are flushed each period
+             */
+            TrafficMatrixWriter(const std::string& filename, uint16_t x_size, uint16_t y_size,
+                                const std::vector<std::string>& networks, bool flush);
+
+            /*!
+             * \brief Destructor for TrafficMatrixWriter. Writes the pending slices and joins the thread
+             */
+            ~TrafficMatrixWriter();
+
+            TrafficMatrixWriter(const TrafficMatrixWriter&)=delete;
+            TrafficMatrixWriter& operator=(const TrafficMatrixWriter&)=delete;
+
+            /*!
+             * \brief Queue a slice to be written. The counts are copied, so they can be modified right after the call
+             * \param cycle The cycle of the slice
+             * \param counts The packet counts, with the layout of the file
+             */
+            void append(uint64_t cycle, const std::vector<uint64_t>& counts);
+
+        private:
+            /*!
+             * \brief The loop of the writing thread
+             */
+            void write_();
+
+            static constexpr char MAGIC[8]={'C', 'O', 'Y', 'N', 'O', 'C', 'T', 'M'}; //! Identifies the files
+            static constexpr uint32_t VERSION=1;                                     //! The version of the format
+
+            std::ofstream file_;                                            //! The output file
+            size_t slice_size_;                                             //! The number of counts in a slice
+            std::mutex mutex_;                                              //! Protects the queues
+            std::condition_variable pending_cv_;                            //! Wakes the thread when a slice is queued
+            std::deque<std::pair<uint64_t, std::vector<uint64_t>>> pending_;//! The slices waiting to be written
+            std::vector<std::vector<uint64_t>> free_buffers_;               //! Buffers of written slices to reuse
+            bool done_;                                                     //! No more slices will be queued
+            std::thread thread_;                                            //! The writing thread
+    };
+}
+#endif
@@ -0,0 +1,226 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#ifndef __PENDING_REQUEST_QUEUE_HH__
+#define __PENDING_REQUEST_QUEUE_HH__
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "sparta/utils/SpartaAssert.hpp"
+#include "CacheRequest.hpp"
+#include "ScratchpadRequest.hpp"
+
+namespace coyote
+{
+    /*!
+     * \class coyote::RingQueue
+     * \brief A FIFO queue on a circular buffer that doubles its capacity when it gets full,
+     * so pushes and pops do not allocate in the steady state.
+     */
+    template<class T>
+    class RingQueue
+    {
+        public:
+            RingQueue() : buffer_(INITIAL_CAPACITY), head_(0), size_(0) {}
+
+            void push_back(const T& elem)
+            {
+                if(size_==buffer_.size())
+                {
+                    grow_();
+                }
+                buffer_[(head_+size_) & (buffer_.size()-1)]=elem;
+                size_++;
+            }
+
+            const T& front() const
+            {
+                sparta_assert(size_>0, "Front of an empty queue");
+                return buffer_[head_];
+            }
+
+            void pop_front()
+            {
+                sparta_assert(size_>0, "Pop from an empty queue");
+                buffer_[head_]=T(); //Release the element
+                head_=(head_+1) & (buffer_.size()-1);
+                size_--;
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            bool empty() const
+            {
+                return size_==0;
+            }
+
+        private:
+            static constexpr size_t INITIAL_CAPACITY=16; //Must be a power of 2
+
+            std::vector<T> buffer_;
+            size_t head_;
+            size_t size_;
+
+            void grow_()
+            {
+                std::vector<T> bigger(buffer_.size()*2);
+                for(size_t i=0; i<size_; i++)
+                {
+                    bigger[i]=std::move(buffer_[(head_+i) & (buffer_.size()-1)]);
+                }
+                buffer_.swap(bigger);
+                head_=0;
+            }
+    };
+
+    /*!
+     * \class coyote::PendingRequestQueue
+     * \brief The requests waiting to be issued to a cache bank. There is a queue per class of request
+     * and they are served in the order scratchpad > fetch > load > store. Writebacks share the queue of
+     * stores, and the lines they hold are indexed so that loads can check for hits on them in constant time.
+     */
+    class PendingRequestQueue
+    {
+        public:
+            /*!
+            * \brief Enqueue a cache request
+            * \param req The request
+            * \param line The address of the line of the request
+            */
+            void push(const std::shared_ptr<CacheRequest>& req, uint64_t line)
+            {
+                switch(req->getType())
+                {
+                    case CacheRequest::AccessType::FETCH:
+                        fetches_.push_back(Entry{req, line});
+                        break;
+
+                    case CacheRequest::AccessType::LOAD:
+                        loads_.push_back(Entry{req, line});
+                        break;
+
+                    case CacheRequest::AccessType::WRITEBACK:
+                        pending_writebacks_[line]++;
+                        stores_.push_back(Entry{req, line});
+                        break;
+
+                    case CacheRequest::AccessType::STORE:
+                        stores_.push_back(Entry{req, line});
+                        break;
+                }
+            }
+
+            /*!
+            * \brief Enqueue a scratchpad request
+            * \param req The request
+            */
+            void push(const std::shared_ptr<ScratchpadRequest>& req)
+            {
+                scratchpad_.push_back(req);
+            }
+
+            /*!
+            * \brief Whether there are pending scratchpad requests
+            * \return True if there is at least one
+            */
+            bool hasScratchpadRequests() const
+            {
+                return !scratchpad_.empty();
+            }
+
+            /*!
+            * \brief Dequeue the oldest scratchpad request
+            * \return The request
+            */
+            std::shared_ptr<ScratchpadRequest> popScratchpadRequest()
+            {
+                std::shared_ptr<ScratchpadRequest> req=scratchpad_.front();
+                scratchpad_.pop_front();
+                return req;
+            }
+
+            /*!
+            * \brief Whether there are pending fetch, load, store or writeback requests
+            * \return True if there is at least one
+            */
+            bool hasCacheRequests() const
+            {
+                return !fetches_.empty() || !loads_.empty() || !stores_.empty();
+            }
+
+            /*!
+            * \brief Dequeue the oldest request of the class with the highest priority (fetch > load > store)
+            * \return The request
+            */
+            std::shared_ptr<CacheRequest> popCacheRequest()
+            {
+                RingQueue<Entry>& queue=!fetches_.empty() ? fetches_ : (!loads_.empty() ? loads_ : stores_);
+                Entry e=queue.front();
+                queue.pop_front();
+
+                if(e.req->getType()==CacheRequest::AccessType::WRITEBACK)
+                {
+                    auto it=pending_writebacks_.find(e.line);
+                    if(--it->second==0)
+                    {
+                        pending_writebacks_.erase(it);
+                    }
+                }
+                return e.req;
+            }
+
+            /*!
+            * \brief Whether a writeback of a line is waiting in the queue
+            * \param line The address of the line
+            * \return True if there is a pending writeback for the line
+            */
+            bool hasPendingWriteback(uint64_t line) const
+            {
+                return pending_writebacks_.find(line)!=pending_writebacks_.end();
+            }
+
+            /*!
+            * \brief Get the number of pending requests of any class
+            * \return The number of requests
+            */
+            size_t size() const
+            {
+                return scratchpad_.size()+fetches_.size()+loads_.size()+stores_.size();
+            }
+
+        private:
+            struct Entry
+            {
+                std::shared_ptr<CacheRequest> req;
+                uint64_t line;
+            };
+
+            RingQueue<std::shared_ptr<ScratchpadRequest>> scratchpad_;
+            RingQueue<Entry> fetches_;
+            RingQueue<Entry> loads_;
+            RingQueue<Entry> stores_;                                 //! Stores and writebacks, in arrival order
+            std::unordered_map<uint64_t, uint32_t> pending_writebacks_; //! Number of queued writebacks of each line
+    };
+}
+#endif
@@ -0,0 +1,48 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "PrefetcherIF.hpp"
+
+namespace coyote
+{
+    PrefetcherIF::PrefetcherIF(uint64_t line_stride, uint16_t degree) :
+        line_stride(line_stride),
+        degree(degree)
+    {}
+
+    int64_t PrefetcherIF::toLineIndex(uint64_t addr) const
+    {
+        return addr/line_stride;
+    }
+
+    void PrefetcherIF::appendLines(uint64_t line_addr, int64_t stride, std::vector<uint64_t>& candidates) const
+    {
+        //The offset inside the stride selects the bank and tile, so it is kept to stay in the lines mapped to the bank
+        int64_t line_index=toLineIndex(line_addr);
+        uint64_t offset=line_addr%line_stride;
+        for(int64_t i=1; i<=degree; i++)
+        {
+            int64_t target=line_index+i*stride;
+            if(target>=0)
+            {
+                candidates.push_back(target*line_stride+offset);
+            }
+        }
+    }
+}
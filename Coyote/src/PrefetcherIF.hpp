@@ -0,0 +1,81 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#ifndef __PREFETCHER_IF_HH__
+#define __PREFETCHER_IF_HH__
+
+#include <cstdint>
+#include <vector>
+
+namespace coyote
+{
+    class PrefetcherIF
+    {
+        /*!
+         * \class coyote::PrefetcherIF
+         * \brief Abstract class representing a prefetcher attached to a CacheBank.
+         *
+         * Prefetchers observe the demand accesses to the bank and propose the lines that should be prefetched.
+         * They work on the line stride of the bank, i.e. the distance between consecutive lines that are mapped
+         * to the same bank, so the proposed lines belong to the bank that observed the access. The bank is in
+         * charge of filtering the lines that are already present or pending and of issuing the prefetches.
+         */
+        public:
+
+            /*!
+            * \brief Constructor for PrefetcherIF
+            * \param line_stride The distance in bytes between two consecutive lines mapped to the bank
+            * \param degree The maximum number of lines proposed for each access
+            */
+            PrefetcherIF(uint64_t line_stride, uint16_t degree);
+
+            virtual ~PrefetcherIF() {}
+
+            /*!
+            * \brief Observe a demand access to the bank
+            * \param line_addr The address of the accessed line
+            * \param pc The PC of the instruction that made the access
+            * \param miss True if the access missed in the bank
+            * \param prefetch_hit True if the access is the first one to hit on a prefetched line
+            * \param candidates The addresses of the lines to prefetch are appended here
+            */
+            virtual void notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates)=0;
+
+        protected:
+            uint64_t line_stride;
+            uint16_t degree;
+
+            /*!
+            * \brief Convert an address to its index in the sequence of lines mapped to the bank
+            * \param addr The address
+            * \return The index of the line
+            */
+            int64_t toLineIndex(uint64_t addr) const;
+
+            /*!
+            * \brief Append the lines mapped to the bank at a distance of 1..degree times a stride from a line
+            * \param line_addr The address of the line
+            * \param stride The stride in lines mapped to the bank (might be negative)
+            * \param candidates The vector where the addresses of the lines are appended
+            */
+            void appendLines(uint64_t line_addr, int64_t stride, std::vector<uint64_t>& candidates) const;
+    };
+}
+#endif
@@ -82,6 +82,12 @@ namespace coyote
              */
             uint64_t getAddress() const {return address;}
 
+            /*!
+             * \brief Set the address of the request
+             * \param a The address
+             */
+            void setAddress(uint64_t a) {address=a;}
+
             /*!
              * \brief Set the size of the request in bytes
              * \param s The size
@@ -120,7 +126,7 @@ namespace coyote
             uint64_t address;
             uint16_t cache_bank;
  
-            uint16_t size;
+            uint16_t size=0;
     };
 
     inline std::ostream & operator<<(std::ostream & Str, Request const & req)
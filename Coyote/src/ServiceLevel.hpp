@@ -0,0 +1,36 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __SERVICE_LEVEL_HH__
+#define __SERVICE_LEVEL_HH__
+
+/*!
+ * \brief The level of the memory hierarchy that serviced a request. Used to attribute
+ * the stall cycles of a core to the level that served the request blocking it.
+ */
+enum class ServiceLevel{
+    NONE,
+    L2,
+    REMOTE_L2,
+    LLC,
+    MEMORY,
+    MAX_LEVELS
+};
+
+#endif
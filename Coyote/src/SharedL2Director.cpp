@@ -19,6 +19,7 @@
 
 #include "SharedL2Director.hpp"
 #include "CacheRequest.hpp"
+#include "Tile.hpp"
 
 namespace coyote
 {
@@ -27,7 +28,197 @@ namespace coyote
 	return s*1024*num_tiles;
     }
 
+    void SharedL2Director::setPageTable(std::shared_ptr<FirstTouchPageTable> p)
+    {
+        page_table_=p;
+        tile_data_mapping_policy_=CacheDataMappingPolicy::PAGE_TO_BANK;
+    }
+
+    void SharedL2Director::setDNUCA(std::shared_ptr<DNUCALocationTable> t, uint16_t migration_threshold, uint16_t replication_threshold, bool search_home)
+    {
+        dnuca_table_=t;
+        migration_threshold_=migration_threshold;
+        replication_threshold_=replication_threshold;
+        search_home_=search_home;
+    }
+
+    void SharedL2Director::notifyServiced_(std::shared_ptr<coyote::CacheRequest> r)
+    {
+        if(dnuca_table_ && !r->getBypassL2())
+        {
+            if(r->getSourceTile()!=tile->id_)
+            {
+                if(r->getHomeTile()==tile->id_)
+                {
+                    recordRemoteService_(r);
+                }
+            }
+            else if(r->allocatesInSource())
+            {
+                //The data of the line has reached the requesting tile
+                uint64_t line=(r->getAddress() >> block_offset_bits) << block_offset_bits;
+                std::shared_ptr<CacheRequest> fill=std::make_shared<CacheRequest>(line, CacheRequest::AccessType::LOAD, r->getPC(), tile->getClock()->currentCycle(), r->getCoreId());
+                fill->setFillOnly();
+                fill->setSourceTile(tile->id_);
+                fill->setHomeTile(tile->id_);
+                fill->setCacheBank(calculateBank(fill));
+                tile->issueLocalRequest_(fill, 0);
+            }
+        }
+    }
+
     uint16_t SharedL2Director::calculateHome(std::shared_ptr<coyote::CacheRequest> r)
+    {
+        uint16_t home=0;
+        if(!page_table_)
+        {
+            home=calculateInterleavedHome_(r->getAddress(), tile_data_mapping_policy_);
+        }
+        else
+        {
+            switch(page_table_->access(r->getAddress(), r->getSourceTile(), home))
+            {
+                case FirstTouchPageTable::Placement::FIRST_TOUCH:
+                    tile->count_first_touch_pages_++;
+                    break;
+                case FirstTouchPageTable::Placement::PRIVATE:
+                    break;
+                case FirstTouchPageTable::Placement::NEW_SHARED:
+                    tile->count_shared_pages_++;
+                    home=calculateSharedPageHome_(r->getAddress());
+                    break;
+                case FirstTouchPageTable::Placement::SHARED:
+                    home=calculateSharedPageHome_(r->getAddress());
+                    break;
+            }
+        }
+
+        if(dnuca_table_)
+        {
+            home=calculateDNUCAHome_(r, home);
+        }
+        return home;
+    }
+
+    uint16_t SharedL2Director::calculateDNUCAHome_(std::shared_ptr<coyote::CacheRequest> r, uint16_t home)
+    {
+        uint64_t line=(r->getAddress() >> block_offset_bits) << block_offset_bits;
+        DNUCALocationTable::Line * l=dnuca_table_->find(line);
+        if(l==nullptr)
+        {
+            return home;
+        }
+
+        //Requests forwarded by the home tile or by a tile the line migrated away from while they were in flight
+        if(r->getSourceTile()!=tile->id_)
+        {
+            if(l->location!=tile->id_)
+            {
+                tile->count_dnuca_forwarded_requests_++;
+            }
+            return l->location;
+        }
+
+        if(r->getType()==CacheRequest::AccessType::STORE || r->getType()==CacheRequest::AccessType::WRITEBACK)
+        {
+            for(uint16_t t : l->replicas)
+            {
+                invalidateLine_(line, r, t);
+                tile->count_dnuca_replica_invalidations_++;
+            }
+            l->replicas.clear();
+            l->written=true;
+        }
+        else if(l->hasReplica(tile->id_))
+        {
+            tile->count_dnuca_replica_requests_++;
+            return tile->id_;
+        }
+
+        //Accesses of the tile that holds the line break the run of remote hits, which prevents lines from bouncing between tiles
+        if(l->location==tile->id_)
+        {
+            l->hits=0;
+        }
+        else if(search_home_ && home!=tile->id_)
+        {
+            return home;
+        }
+        return l->location;
+    }
+
+    void SharedL2Director::recordRemoteService_(std::shared_ptr<coyote::CacheRequest> r)
+    {
+        //Only hits move lines
+        if(r->getServiceLevel()!=ServiceLevel::L2)
+        {
+            return;
+        }
+
+        uint64_t line=(r->getAddress() >> block_offset_bits) << block_offset_bits;
+        DNUCALocationTable::Line& l=dnuca_table_->get(line, tile->id_);
+        if(l.location!=tile->id_) //The line has moved while the request was in flight
+        {
+            return;
+        }
+
+        uint16_t source=r->getSourceTile();
+        if(l.requester==source)
+        {
+            if(l.hits<UINT16_MAX)
+            {
+                l.hits++;
+            }
+        }
+        else
+        {
+            l.requester=source;
+            l.hits=1;
+        }
+
+        //Stores are acknowledged by the tile that holds the line and carry no data back, so lines only move on reads
+        if(r->getType()==CacheRequest::AccessType::STORE || r->getType()==CacheRequest::AccessType::WRITEBACK)
+        {
+            l.written=true;
+            return;
+        }
+
+        if(replication_threshold_!=0 && !l.written && l.hits>=replication_threshold_ && !l.hasReplica(source))
+        {
+            l.replicas.push_back(source);
+            l.hits=0;
+            r->setAllocateInSource();
+            tile->count_dnuca_replications_++;
+        }
+        else if(migration_threshold_!=0 && l.hits>=migration_threshold_ && l.replicas.empty())
+        {
+            l.location=source;
+            l.hits=0;
+            l.written=false;
+            invalidateLine_(line, r, tile->id_);
+            r->setAllocateInSource();
+            tile->count_dnuca_migrations_++;
+        }
+    }
+
+    void SharedL2Director::invalidateLine_(uint64_t line, std::shared_ptr<coyote::CacheRequest> r, uint16_t t)
+    {
+        std::shared_ptr<CacheRequest> c=std::make_shared<CacheRequest>(line, CacheRequest::AccessType::LOAD, r->getPC(), tile->getClock()->currentCycle(), r->getCoreId());
+        c->setCoherenceCommand(CacheRequest::CoherenceCommand::INVALIDATE);
+        c->setSourceTile(r->getSourceTile());
+        c->setHomeTile(tile->id_); //Remote tiles acknowledge the invalidation to this tile
+        if(t==tile->id_)
+        {
+            c->setCacheBank(calculateBank(c));
+            tile->issueLocalRequest_(c, 0);
+        }
+        else
+        {
+            sendCoherenceMessage_(c, NoCMessageType::COHERENCE_INVALIDATE, t, true, c->getCoreId());
+        }
+    }
+
+    uint16_t SharedL2Director::calculateInterleavedHome_(uint64_t address, CacheDataMappingPolicy policy)
     {
         uint16_t destination=0;
         
@@ -35,7 +226,7 @@ namespace coyote
         {
             uint8_t left=tag_bits;
             uint8_t right=block_offset_bits;
-            switch(tile_data_mapping_policy_)
+            switch(policy)
             {
                 case CacheDataMappingPolicy::SET_INTERLEAVING:
                     left+=set_bits-tile_bits;
@@ -44,10 +235,22 @@ namespace coyote
                     right+=set_bits-tile_bits;
                     break;
             }
-            destination=(r->getAddress() << left) >> (left+right);
+            destination=(address << left) >> (left+right);
         }
         return destination;
     }
+
+    uint16_t SharedL2Director::calculateSharedPageHome_(uint64_t address)
+    {
+        //The tiles are selected by page_to_bank with the first_touch policy, so set interleaved banks take the lowest set bits.
+        //The lines of shared pages are interleaved among the tiles with the bits right above them to use every bank.
+        uint8_t bank_shift=0;
+        if(bank_data_mapping_policy_==CacheDataMappingPolicy::SET_INTERLEAVING)
+        {
+            bank_shift=bank_bits;
+        }
+        return calculateInterleavedHome_(address >> bank_shift, CacheDataMappingPolicy::SET_INTERLEAVING);
+    }
     
     uint16_t SharedL2Director::calculateBank(std::shared_ptr<coyote::CacheRequest> r)
     {
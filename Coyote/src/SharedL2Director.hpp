@@ -23,6 +23,8 @@
 
 #include <memory>
 #include "AccessDirector.hpp"
+#include "FirstTouchPageTable.hpp"
+#include "DNUCALocationTable.hpp"
 
 namespace coyote
 {
@@ -50,10 +52,33 @@ namespace coyote
              */
             SharedL2Director(Tile * t, CacheDataMappingPolicy b, VRegMappingPolicy s, CacheDataMappingPolicy d) 
                                                     : AccessDirector(t, b, s), tile_data_mapping_policy_(d){}
-            
+
+            /*!
+             * \brief Place the pages in the tiles with a first-touch policy instead of the tile data mapping policy
+             * \param p The page table, shared by the directors of all the tiles. Shared pages are interleaved as with SET_INTERLEAVING
+             * \note Banks within the tile are selected as with the PAGE_TO_BANK tile data mapping policy
+             */
+            void setPageTable(std::shared_ptr<FirstTouchPageTable> p);
+
+            /*!
+             * \brief Let the lines move away from their home tile (D-NUCA)
+             * \param t The location table, shared by the directors of all the tiles
+             * \param migration_threshold The consecutive remote hits of a tile after which a line migrates to it. 0 disables migration
+             * \param replication_threshold The consecutive remote read hits of a tile after which a line that has not been written
+             * is replicated in it. 0 disables replication
+             * \param search_home Whether requests for a migrated line are sent to its home tile, which forwards them, instead of
+             * straight to the tile that holds it
+             */
+            void setDNUCA(std::shared_ptr<DNUCALocationTable> t, uint16_t migration_threshold, uint16_t replication_threshold, bool search_home);
 
         private:
             CacheDataMappingPolicy tile_data_mapping_policy_;
+            std::shared_ptr<FirstTouchPageTable> page_table_; //! nullptr unless pages are placed on first touch
+
+            std::shared_ptr<DNUCALocationTable> dnuca_table_; //! nullptr unless lines may leave their home tile
+            uint16_t migration_threshold_=0;
+            uint16_t replication_threshold_=0;
+            bool search_home_=false;
             
             /*!              
             * \brief Calculate the home tile for a request
@@ -61,6 +86,51 @@ namespace coyote
             * \return The home tile
             */
             uint16_t calculateHome(std::shared_ptr<coyote::CacheRequest> r) override;
+
+            /*!
+            * \brief Record the remote hits on the lines of the tile and allocate the lines that migrate or are replicated to it
+            * \param r The serviced request
+            */
+            void notifyServiced_(std::shared_ptr<coyote::CacheRequest> r) override;
+
+            /*!
+            * \brief Calculate the home tile of an address from its bits
+            * \param address The address
+            * \param policy The data mapping policy for tiles
+            * \return The home tile
+            */
+            uint16_t calculateInterleavedHome_(uint64_t address, CacheDataMappingPolicy policy);
+
+            /*!
+            * \brief Calculate the home tile of a line of a page shared by several tiles with the first_touch policy
+            * \param address The address
+            * \return The home tile, taken from the address bits right above those that select the bank
+            */
+            uint16_t calculateSharedPageHome_(uint64_t address);
+
+            /*!
+            * \brief Calculate the tile that services a request when lines may leave their home tile. Requests for lines
+            * with a replica in the source tile are serviced locally, and writes invalidate the replicas of their line
+            * \param r The request
+            * \param home The static home tile of the request
+            * \return The tile to send the request to
+            */
+            uint16_t calculateDNUCAHome_(std::shared_ptr<coyote::CacheRequest> r, uint16_t home);
+
+            /*!
+            * \brief Update the location of a line after a request from another tile has been serviced by the L2 of this tile.
+            * The line migrates or is replicated to the requesting tile after enough consecutive hits
+            * \param r The serviced request
+            */
+            void recordRemoteService_(std::shared_ptr<coyote::CacheRequest> r);
+
+            /*!
+            * \brief Invalidate a line in a bank of a tile
+            * \param line The address of the line
+            * \param r The request that triggers the invalidation
+            * \param t The tile
+            */
+            void invalidateLine_(uint64_t line, std::shared_ptr<coyote::CacheRequest> r, uint16_t t);
             
             /*!              
             * \brief Calculate the bank for a request
@@ -41,7 +41,12 @@ namespace coyote
             valid_(false),
             modified_(false),
             accessed_by_vector_(false),
-            accessed_by_non_vector_(false)
+            accessed_by_non_vector_(false),
+            filled_by_vector_(false),
+            reused_(false),
+            prefetched_(false),
+            partition_(0),
+            last_access_(0)
         {
             sparta_assert(sparta::utils::is_power_of_2(line_size),
                 "Cache line size must be a power of 2. line_size=" << line_size);
@@ -54,7 +59,12 @@ namespace coyote
             valid_(rhs.valid_),
             modified_(rhs.modified_),
             accessed_by_vector_(rhs.accessed_by_vector_),
-            accessed_by_non_vector_(rhs.accessed_by_non_vector_)
+            accessed_by_non_vector_(rhs.accessed_by_non_vector_),
+            filled_by_vector_(rhs.filled_by_vector_),
+            reused_(rhs.reused_),
+            prefetched_(rhs.prefetched_),
+            partition_(rhs.partition_),
+            last_access_(rhs.last_access_)
         {
         }
 
@@ -77,6 +87,9 @@ namespace coyote
             setModified(false);
             setAccessedByVector(false);
             setAccessedByNonVector(false);
+            setFilledByVector(false);
+            setReused(false);
+            setPrefetched(false);
             BasicCacheItem::setAddr(addr);
         }
 
@@ -93,6 +106,16 @@ namespace coyote
         bool getAccessedByVector() { return accessed_by_vector_; }
         void setAccessedByNonVector(bool a) { accessed_by_non_vector_=a; }
         bool getAccessedByNonVector() { return accessed_by_non_vector_; }
+        void setFilledByVector(bool f) { filled_by_vector_=f; }
+        bool getFilledByVector() const { return filled_by_vector_; }
+        void setReused(bool r) { reused_=r; }
+        bool getReused() const { return reused_; }
+        void setPrefetched(bool p) { prefetched_=p; }
+        bool getPrefetched() const { return prefetched_; }
+        void setPartition(uint16_t p) { partition_=p; }
+        uint16_t getPartition() const { return partition_; }
+        void setLastAccess(uint64_t c) { last_access_=c; }
+        uint64_t getLastAccess() const { return last_access_; }
 
         // Required by SimpleCache2
         bool read(uint64_t offset, uint32_t size, uint32_t *buf) const
@@ -122,6 +145,11 @@ namespace coyote
         bool modified_;
         bool accessed_by_vector_;
         bool accessed_by_non_vector_;
+        bool filled_by_vector_; // The line was brought by a vector request
+        bool reused_;           // The line has been hit since it was filled
+        bool prefetched_;       // The line was brought by a prefetch and has not been demanded yet
+        uint16_t partition_;    // The way partition of the request that brought the line
+        uint64_t last_access_;  // Cycle of the last fill or hit, used to replace lines within a way partition
         }; // class SimpleCacheLine
 
     //class SimpleDL2 : public sparta::cache::SimpleCache2<SimpleCacheLine>,
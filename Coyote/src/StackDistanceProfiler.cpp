@@ -0,0 +1,110 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "sparta/utils/SpartaAssert.hpp"
+#include "StackDistanceProfiler.hpp"
+
+namespace coyote
+{
+    StackDistanceProfiler::StackDistanceProfiler(uint64_t line_stride, uint32_t sampling, uint64_t max_sets, uint64_t max_associativity) :
+        line_stride_(line_stride),
+        sampling_(sampling),
+        max_associativity_(max_associativity),
+        sampled_accesses_(0),
+        levels_()
+    {
+        sparta_assert(sampling>0 && (sampling & (sampling-1))==0, "The stack distance sampling must be a power of 2");
+        sparta_assert(max_associativity>0 && (max_associativity & (max_associativity-1))==0, "The largest profiled associativity must be a power of 2");
+        sparta_assert(max_sets>=sampling && (max_sets & (max_sets-1))==0, "The largest profiled number of sets must be a power of 2 and at least the sampling");
+
+        for(uint64_t sets=sampling; sets<=max_sets; sets*=2)
+        {
+            levels_.push_back(Level{sets, std::vector<uint64_t>(sets/sampling*max_associativity, NO_LINE), std::vector<uint64_t>(max_associativity+1, 0)});
+        }
+    }
+
+    void StackDistanceProfiler::access(uint64_t address)
+    {
+        uint64_t line=address/line_stride_;
+        if(line%sampling_!=0)
+        {
+            return;
+        }
+        sampled_accesses_++;
+
+        for(Level& level : levels_)
+        {
+            uint64_t * stack=&level.stacks[(line%level.sets)/sampling_*max_associativity_];
+            uint64_t distance=0;
+            while(distance<max_associativity_ && stack[distance]!=line)
+            {
+                distance++;
+            }
+            level.histogram[distance]++;
+
+            //Move the line to the top of the stack. If it was not found, the least recently used line is dropped
+            uint64_t last=(distance<max_associativity_) ? distance : max_associativity_-1;
+            for(uint64_t i=last; i>0; i--)
+            {
+                stack[i]=stack[i-1];
+            }
+            stack[0]=line;
+        }
+    }
+
+    uint64_t StackDistanceProfiler::getMisses(uint64_t sets, uint64_t associativity) const
+    {
+        sparta_assert(associativity>0 && associativity<=max_associativity_, "Associativity " << associativity << " has not been profiled");
+        for(const Level& level : levels_)
+        {
+            if(level.sets==sets)
+            {
+                uint64_t hits=0;
+                for(uint64_t d=0; d<associativity; d++)
+                {
+                    hits+=level.histogram[d];
+                }
+                return sampled_accesses_-hits;
+            }
+        }
+        sparta_assert(false, "Caches with " << sets << " sets have not been profiled");
+        return 0;
+    }
+
+    void StackDistanceProfiler::writeMissRatioCurves(std::ostream& str, uint64_t line_size) const
+    {
+        str << "size_kb;associativity;sets;sampled_accesses;sampled_misses;miss_ratio\n";
+        //The largest profiled size is the one of the direct-mapped caches with the most sets, and it caps every associativity
+        uint64_t max_lines=levels_.back().sets;
+        for(const Level& level : levels_)
+        {
+            for(uint64_t associativity=1; associativity<=max_associativity_ && level.sets*associativity<=max_lines; associativity*=2)
+            {
+                uint64_t size=level.sets*associativity*line_size;
+                if(size<1024)
+                {
+                    continue;
+                }
+                uint64_t misses=getMisses(level.sets, associativity);
+                str << size/1024 << ";" << associativity << ";" << level.sets << ";" << sampled_accesses_ << ";" << misses << ";"
+                    << ((sampled_accesses_>0) ? (double)misses/sampled_accesses_ : 0.0) << "\n";
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __STACK_DISTANCE_PROFILER_HH__
+#define __STACK_DISTANCE_PROFILER_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace coyote
+{
+    class StackDistanceProfiler
+    {
+        /*!
+         * \class coyote::StackDistanceProfiler
+         * \brief Estimates in a single pass the miss ratio of LRU caches of every power-of-two number of sets
+         * and associativity that see the same stream of accesses.
+         *
+         * For each number of sets, the LRU stack of every sampled set is kept up to the largest profiled
+         * associativity (Mattson's stack algorithm). An access at stack distance d hits in all the caches
+         * with that number of sets and more than d ways. Only one out of every sampling sets is profiled.
+         * A set is sampled for all the profiled numbers of sets, so these start at sampling sets.
+         */
+        public:
+
+            /*!
+            * \brief Constructor for StackDistanceProfiler
+            * \param line_stride The distance in bytes between two consecutive lines mapped to the cache
+            * \param sampling One out of every sampling sets is profiled (power of 2)
+            * \param max_sets The largest number of sets that is profiled (power of 2, at least sampling)
+            * \param max_associativity The largest associativity that is profiled (power of 2)
+            */
+            StackDistanceProfiler(uint64_t line_stride, uint32_t sampling, uint64_t max_sets, uint64_t max_associativity);
+
+            /*!
+            * \brief Record an access
+            * \param address The accessed address
+            */
+            void access(uint64_t address);
+
+            /*!
+            * \brief Get the number of accesses to the sampled sets
+            * \return The number of accesses
+            */
+            uint64_t getSampledAccesses() const
+            {
+                return sampled_accesses_;
+            }
+
+            /*!
+            * \brief Get the number of misses to the sampled sets of a cache
+            * \param sets The number of sets of the cache (a profiled power of 2)
+            * \param associativity The associativity of the cache (a power of 2 up to the largest profiled one)
+            * \return The number of misses
+            */
+            uint64_t getMisses(uint64_t sets, uint64_t associativity) const;
+
+            /*!
+            * \brief Write the miss ratio curves as a CSV with one line per cache of at least 1KB and at most the size of the
+            * direct-mapped cache with max_sets sets
+            * \param str The stream to write
+            * \param line_size The size of a line in bytes, used to get the size of each cache
+            */
+            void writeMissRatioCurves(std::ostream& str, uint64_t line_size) const;
+
+        private:
+            struct Level
+            {
+                uint64_t sets;                    //! The number of sets of the caches profiled by the level
+                std::vector<uint64_t> stacks;     //! max_associativity_ lines per sampled set, most recently used first
+                std::vector<uint64_t> histogram;  //! Accesses at each stack distance. The last entry counts the larger distances and the cold misses
+            };
+
+            static constexpr uint64_t NO_LINE=UINT64_MAX;
+
+            uint64_t line_stride_;
+            uint32_t sampling_;
+            uint64_t max_associativity_;
+            uint64_t sampled_accesses_;
+            std::vector<Level> levels_;   //! One per profiled number of sets, in increasing order
+    };
+}
+#endif
@@ -27,6 +27,7 @@ enum class StallReason{
     WAITING_ON_BARRIER,
     CORE_FINISHED,
     VECTOR_WAITING_ON_SCALAR_STORE,
+    ARBITER_FULL,
     MAX_REASONS
 };
 
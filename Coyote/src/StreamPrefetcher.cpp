@@ -0,0 +1,85 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "StreamPrefetcher.hpp"
+
+namespace coyote
+{
+    StreamPrefetcher::StreamPrefetcher(uint64_t line_stride, uint16_t degree) :
+        PrefetcherIF(line_stride, degree),
+        streams(NUM_STREAMS),
+        accesses(0)
+    {}
+
+    void StreamPrefetcher::notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates)
+    {
+        if(!miss && !prefetch_hit)
+        {
+            return;
+        }
+
+        accesses++;
+        int64_t line=toLineIndex(line_addr);
+
+        Stream* victim=&streams[0];
+        for(Stream& s : streams)
+        {
+            if(s.valid)
+            {
+                int64_t distance=line-s.last_line;
+                if(distance!=0 && distance>=-WINDOW && distance<=WINDOW)
+                {
+                    int64_t direction=(distance>0) ? 1 : -1;
+                    if(direction==s.direction)
+                    {
+                        if(s.confidence<2)
+                        {
+                            s.confidence++;
+                        }
+                    }
+                    else
+                    {
+                        s.direction=direction;
+                        s.confidence=1;
+                    }
+                    s.last_line=line;
+                    s.last_use=accesses;
+
+                    if(s.confidence>=2)
+                    {
+                        appendLines(line_addr, s.direction, candidates);
+                    }
+                    return;
+                }
+            }
+
+            if(!s.valid || (victim->valid && s.last_use<victim->last_use))
+            {
+                victim=&s;
+            }
+        }
+
+        //Allocate a new stream
+        victim->last_line=line;
+        victim->direction=0;
+        victim->confidence=0;
+        victim->last_use=accesses;
+        victim->valid=true;
+    }
+}
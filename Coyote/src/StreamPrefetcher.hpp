@@ -0,0 +1,74 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#ifndef __STREAM_PREFETCHER_HH__
+#define __STREAM_PREFETCHER_HH__
+
+#include "PrefetcherIF.hpp"
+
+namespace coyote
+{
+    class StreamPrefetcher : public PrefetcherIF
+    {
+        /*!
+         * \class coyote::StreamPrefetcher
+         * \brief Stream prefetcher. It tracks up to NUM_STREAMS streams of misses (and first hits on
+         * prefetched lines), regardless of the instructions that make them. An access within WINDOW
+         * lines of the last access of a stream extends it. Once a stream has advanced twice in the same
+         * direction, each access that extends it prefetches the next degree lines in that direction.
+         * Streams are replaced in LRU order.
+         */
+        public:
+
+            /*!
+            * \brief Constructor for StreamPrefetcher
+            * \param line_stride The distance in bytes between two consecutive lines mapped to the bank
+            * \param degree The number of lines prefetched ahead of a confirmed stream
+            */
+            StreamPrefetcher(uint64_t line_stride, uint16_t degree);
+
+            /*!
+            * \brief Observe a demand access to the bank
+            * \param line_addr The address of the accessed line
+            * \param pc The PC of the instruction that made the access
+            * \param miss True if the access missed in the bank
+            * \param prefetch_hit True if the access is the first one to hit on a prefetched line
+            * \param candidates The addresses of the lines to prefetch are appended here
+            */
+            void notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates) override;
+
+        private:
+            static constexpr uint16_t NUM_STREAMS=16;
+            static constexpr int64_t WINDOW=16;
+
+            struct Stream
+            {
+                int64_t last_line=0;
+                int64_t direction=0;
+                uint8_t confidence=0;
+                uint64_t last_use=0;
+                bool valid=false;
+            };
+
+            std::vector<Stream> streams;
+            uint64_t accesses;
+    };
+}
+#endif
@@ -0,0 +1,75 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include "StridePrefetcher.hpp"
+
+namespace coyote
+{
+    StridePrefetcher::StridePrefetcher(uint64_t line_stride, uint16_t degree) :
+        PrefetcherIF(line_stride, degree),
+        table(TABLE_SIZE)
+    {}
+
+    void StridePrefetcher::notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates)
+    {
+        int64_t line=toLineIndex(line_addr);
+        Entry& e=table[(pc >> 1) % TABLE_SIZE];
+
+        if(!e.valid || e.pc!=pc)
+        {
+            e.pc=pc;
+            e.last_line=line;
+            e.stride=0;
+            e.confidence=0;
+            e.valid=true;
+            return;
+        }
+
+        int64_t stride=line-e.last_line;
+        if(stride==0)
+        {
+            return; //Another access to the same line
+        }
+
+        if(stride==e.stride)
+        {
+            if(e.confidence<MAX_CONFIDENCE)
+            {
+                e.confidence++;
+            }
+        }
+        else
+        {
+            if(e.confidence>0)
+            {
+                e.confidence--;
+            }
+            if(e.confidence==0)
+            {
+                e.stride=stride;
+            }
+        }
+        e.last_line=line;
+
+        if(e.confidence>=CONFIDENCE_THRESHOLD)
+        {
+            appendLines(line_addr, e.stride, candidates);
+        }
+    }
+}
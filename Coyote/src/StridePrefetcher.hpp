@@ -0,0 +1,73 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#ifndef __STRIDE_PREFETCHER_HH__
+#define __STRIDE_PREFETCHER_HH__
+
+#include "PrefetcherIF.hpp"
+
+namespace coyote
+{
+    class StridePrefetcher : public PrefetcherIF
+    {
+        /*!
+         * \class coyote::StridePrefetcher
+         * \brief PC-indexed stride prefetcher. A direct-mapped table indexed by the PC of the accesses
+         * keeps the last line and the last stride of each instruction. Once the same non-zero stride
+         * has been observed CONFIDENCE_THRESHOLD times in a row, every access of the instruction
+         * prefetches the next degree lines following the stride.
+         */
+        public:
+
+            /*!
+            * \brief Constructor for StridePrefetcher
+            * \param line_stride The distance in bytes between two consecutive lines mapped to the bank
+            * \param degree The number of lines prefetched on each access of a trained instruction
+            */
+            StridePrefetcher(uint64_t line_stride, uint16_t degree);
+
+            /*!
+            * \brief Observe a demand access to the bank
+            * \param line_addr The address of the accessed line
+            * \param pc The PC of the instruction that made the access
+            * \param miss True if the access missed in the bank
+            * \param prefetch_hit True if the access is the first one to hit on a prefetched line
+            * \param candidates The addresses of the lines to prefetch are appended here
+            */
+            void notifyAccess(uint64_t line_addr, uint64_t pc, bool miss, bool prefetch_hit, std::vector<uint64_t>& candidates) override;
+
+        private:
+            static constexpr uint16_t TABLE_SIZE=256;
+            static constexpr uint8_t CONFIDENCE_THRESHOLD=2;
+            static constexpr uint8_t MAX_CONFIDENCE=3;
+
+            struct Entry
+            {
+                uint64_t pc=0;
+                int64_t last_line=0;
+                int64_t stride=0;
+                uint8_t confidence=0;
+                bool valid=false;
+            };
+
+            std::vector<Entry> table;
+    };
+}
+#endif
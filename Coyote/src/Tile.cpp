@@ -41,6 +41,15 @@ namespace coyote
         bank_policy_(p->bank_policy),
         scratchpad_policy_(p->scratchpad_policy),
         tile_policy_(p->tile_policy),
+        first_touch_page_size_(p->first_touch_page_size),
+        first_touch_interleave_shared_(p->first_touch_interleave_shared),
+        dnuca_migration_threshold_(p->dnuca_migration_threshold),
+        dnuca_replication_threshold_(p->dnuca_replication_threshold),
+        dnuca_search_(p->dnuca_search),
+        coherent_(p->coherence!="none"),
+        directory_type_(p->directory_type),
+        directory_pointers_(p->directory_pointers),
+        directory_entries_(p->directory_entries),
         in_ports_l2_acks_(num_l2_banks_),
         in_ports_l2_reqs_(num_l2_banks_),
         out_ports_l2_acks_(num_l2_banks_),
@@ -52,6 +61,23 @@ namespace coyote
             "The top.arch.tile*.params.bank_policy must be page_to_bank or set_interleaving");
         sparta_assert(scratchpad_policy_ == "core_to_bank" || scratchpad_policy_ == "vreg_interleaving",
             "The top.arch.tile*.params.scratchpad_policy must be core_to_bank or vreg_interleaving");
+        sparta_assert(tile_policy_ != "first_touch" || l2_sharing_mode_ == "fully_shared",
+            "The first_touch top.arch.tile*.params.tile_policy requires a fully_shared l2_sharing_mode");
+        sparta_assert((dnuca_migration_threshold_ == 0 && dnuca_replication_threshold_ == 0) || l2_sharing_mode_ == "fully_shared",
+            "The top.arch.tile*.params.dnuca_migration_threshold and dnuca_replication_threshold require a fully_shared l2_sharing_mode");
+        //With set_interleaving the tile bits are left out of the set index and the tag, so lines from other home tiles would alias
+        sparta_assert((dnuca_migration_threshold_ == 0 && dnuca_replication_threshold_ == 0) || tile_policy_ != "set_interleaving",
+            "The top.arch.tile*.params.dnuca_migration_threshold and dnuca_replication_threshold require a page_to_bank or first_touch tile_policy");
+        sparta_assert(dnuca_search_ == "location_table" || dnuca_search_ == "home",
+            "The top.arch.tile*.params.dnuca_search must be location_table or home");
+        sparta_assert(p->coherence == "none" || p->coherence == "msi",
+            "The top.arch.tile*.params.coherence must be none or msi");
+        sparta_assert(!coherent_ || l2_sharing_mode_ == "tile_private",
+            "The top.arch.tile*.params.coherence requires a tile_private l2_sharing_mode");
+        sparta_assert(directory_type_ == "full_map" || (directory_type_ == "limited_pointer" && directory_pointers_ > 0),
+            "The top.arch.tile*.params.directory_type must be full_map or limited_pointer with at least one directory_pointers");
+        sparta_assert(!coherent_ || directory_entries_ > 0,
+            "The top.arch.tile*.params.directory_entries must be at least 1");
         node_ = node;
         arbiter = NULL;
 
@@ -122,6 +148,10 @@ namespace coyote
             {
                 t_pol=coyote::CacheDataMappingPolicy::SET_INTERLEAVING;
             }
+            else if(tile_policy_=="first_touch")
+            {
+                t_pol=coyote::CacheDataMappingPolicy::PAGE_TO_BANK; //Used to select the bank. The page table is set by sharePageTable
+            }
             else
             {
                 printf("Unsupported cache data mapping policy\n");
@@ -145,8 +175,43 @@ namespace coyote
         return num_l2_banks_;
     }
 
+    std::shared_ptr<FirstTouchPageTable> Tile::sharePageTable(std::shared_ptr<FirstTouchPageTable> p)
+    {
+        if(tile_policy_=="first_touch")
+        {
+            if(!p)
+            {
+                p=std::make_shared<FirstTouchPageTable>(first_touch_page_size_, first_touch_interleave_shared_);
+            }
+            static_cast<SharedL2Director *>(access_director)->setPageTable(p);
+        }
+        return p;
+    }
+
+    std::shared_ptr<DNUCALocationTable> Tile::shareDNUCATable(std::shared_ptr<DNUCALocationTable> t)
+    {
+        if(dnuca_migration_threshold_!=0 || dnuca_replication_threshold_!=0)
+        {
+            if(!t)
+            {
+                t=std::make_shared<DNUCALocationTable>();
+            }
+            static_cast<SharedL2Director *>(access_director)->setDNUCA(t, dnuca_migration_threshold_, dnuca_replication_threshold_, dnuca_search_=="home");
+        }
+        return t;
+    }
+
     void Tile::issueMemoryControllerRequestFromL2_(const std::shared_ptr<CacheRequest> & req)
     {
+        if(coherent_)
+        {
+            //Misses are issued to memory by the access director when the directory grants them
+            access_director->notifyCoherence(req);
+            if(req->getType()!=CacheRequest::AccessType::WRITEBACK)
+            {
+                return; //Upgrades of lines that are already present do not need to access memory
+            }
+        }
         issueMemoryControllerRequest_(req, false);
     }
 
@@ -250,6 +315,12 @@ namespace coyote
                 case NoCMessageType::SCRATCHPAD_ACK:
                     break;
 
+                case NoCMessageType::COHERENCE_REQUEST:
+                case NoCMessageType::COHERENCE_INVALIDATE:
+                case NoCMessageType::COHERENCE_FORWARD:
+                case NoCMessageType::COHERENCE_ACK:
+                    break;
+
                 default:
                     std::cout << "Unsupported message received from the NoC!!!\n";
             }
@@ -359,6 +430,10 @@ namespace coyote
         setCoresPerTile(num_cores/num_tiles);
         corresponding_mcpu=corr_mcpu;
         access_director->setMemoryInfo(l2_tile_size, assoc, line_size, banks_per_tile, num_tiles, num_mcs, mc_shift, mc_mask, num_cores/num_tiles);
+        if(coherent_)
+        {
+            access_director->enableCoherence(directory_type_=="full_map" ? 0 : directory_pointers_, directory_entries_);
+        }
     }
 
     void Tile::insnLatencyCallback(const std::shared_ptr<coyote::InsnLatencyEvent>& r)
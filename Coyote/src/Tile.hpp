@@ -44,6 +44,8 @@
 #include "LogCapable.hpp"
 #include "AddressMappingPolicy.hpp"
 #include "AccessDirector.hpp"
+#include "FirstTouchPageTable.hpp"
+#include "DNUCALocationTable.hpp"
 #include "MemoryTile/MCPUSetVVL.hpp"
 #include "MemoryTile/MCPUInstruction.hpp"
 #include "CacheRequest.hpp"
@@ -62,6 +64,7 @@ namespace coyote
     {
         using coyote::EventVisitor::handle; //This prevents the compiler from warning on overloading 
         friend class AccessDirector;
+        friend class SharedL2Director;
         friend class FullSystemSimulationEventManager; //Friendship is not inherited. This is to access private method putEvent from SimulationEntryPoint.
 
         /*!
@@ -93,7 +96,16 @@ namespace coyote
                 PARAMETER(std::string, l2_sharing_mode, "tile_private", "How the cache will be shared among the tiles")
                 PARAMETER(std::string, bank_policy, "set_interleaving", "The data mapping policy for banks")
                 PARAMETER(std::string, scratchpad_policy, "core_to_bank", "The data mapping policy for the scratchpad")
-                PARAMETER(std::string, tile_policy, "set_interleaving", "The data mapping policy for tiles")
+                PARAMETER(std::string, tile_policy, "set_interleaving", "The data mapping policy for tiles (page_to_bank, set_interleaving, first_touch)")
+                PARAMETER(uint64_t, first_touch_page_size, 4096, "The size in bytes of the pages placed by the first_touch tile_policy")
+                PARAMETER(bool, first_touch_interleave_shared, true, "Interleave among all the tiles the lines of the pages accessed by more than one tile with the first_touch tile_policy")
+                PARAMETER(uint16_t, dnuca_migration_threshold, 0, "The consecutive remote hits of a tile after which a line of a fully_shared L2 migrates to it (0 disables migration). Requires a page_to_bank or first_touch tile_policy")
+                PARAMETER(uint16_t, dnuca_replication_threshold, 0, "The consecutive remote read hits of a tile after which a line of a fully_shared L2 that has not been written is replicated in it (0 disables replication). Requires a page_to_bank or first_touch tile_policy")
+                PARAMETER(std::string, dnuca_search, "location_table", "How requests find migrated lines (location_table, home)")
+                PARAMETER(std::string, coherence, "none", "The coherence protocol among the tile_private L2s (none, msi)")
+                PARAMETER(std::string, directory_type, "full_map", "The sharer tracking of the directory entries (full_map, limited_pointer)")
+                PARAMETER(uint16_t, directory_pointers, 4, "The number of sharers tracked by a limited_pointer directory entry before it broadcasts invalidations")
+                PARAMETER(uint32_t, directory_entries, 32768, "The number of entries of the directory slice of the tile. When it is full, the least recently used entry is recalled")
             };
 
             /*!
@@ -158,6 +170,15 @@ namespace coyote
             {
                 return num_tiles_;
             }
+
+            /*!
+             * \brief Check if the private L2 of the tile is kept coherent with the others
+             * \return True if the coherence protocol is not none
+             */
+            bool isCoherent()
+            {
+                return coherent_;
+            }
             
             /*!
              * \brief Notify the completion of the service for an L2 request
@@ -212,6 +233,21 @@ namespace coyote
                                 uint64_t num_mcs, uint64_t mc_shift, uint64_t mc_mask, uint16_t num_cores, uint16_t corr_mcpu);
 
             uint16_t getL2Banks();
+
+            /*!
+             * \brief Share the page table of the first_touch tile_policy among the tiles
+             * \param p The page table used by the other tiles, or nullptr if none has been created yet
+             * \return The page table used by the tile. It is p, or a new one if p is nullptr and the tile uses the first_touch tile_policy
+             */
+            std::shared_ptr<FirstTouchPageTable> sharePageTable(std::shared_ptr<FirstTouchPageTable> p);
+
+            /*!
+             * \brief Share the location table of the lines that have left their home tile among the tiles
+             * \param t The location table used by the other tiles, or nullptr if none has been created yet
+             * \return The location table used by the tile. It is t, or a new one if t is nullptr and the tile enables migration or replication
+             */
+            std::shared_ptr<DNUCALocationTable> shareDNUCATable(std::shared_ptr<DNUCALocationTable> t);
+
             std::shared_ptr<FullSystemSimulationEventManager> getRequestManager();
             
         protected:
@@ -232,6 +268,15 @@ namespace coyote
             std::string bank_policy_;
             std::string scratchpad_policy_;
             std::string tile_policy_;
+            uint64_t first_touch_page_size_;
+            bool first_touch_interleave_shared_;
+            uint16_t dnuca_migration_threshold_;
+            uint16_t dnuca_replication_threshold_;
+            std::string dnuca_search_;
+            bool coherent_;
+            std::string directory_type_;
+            uint16_t directory_pointers_;
+            uint32_t directory_entries_;
  
             std::vector<std::unique_ptr<sparta::DataInPort<std::shared_ptr<Request>>>> in_ports_l2_acks_;
             std::vector<std::unique_ptr<sparta::DataInPort<std::shared_ptr<CacheRequest>>>> in_ports_l2_reqs_;
@@ -247,6 +292,20 @@ namespace coyote
 
             sparta::Counter count_local_requests_=sparta::Counter(getStatisticSet(), "requests_from_local_cores", "Number of cache requests from local cores", sparta::Counter::COUNT_NORMAL);
             sparta::Counter count_remote_requests_=sparta::Counter(getStatisticSet(), "requests_from_remote_cores", "Number of cache requests from remote cores", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_directory_requests_=sparta::Counter(getStatisticSet(), "directory_requests", "Number of coherence requests serviced by the directory slice of the tile", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_directory_invalidations_=sparta::Counter(getStatisticSet(), "directory_invalidations", "Number of invalidations sent by the directory slice of the tile", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_directory_forwards_=sparta::Counter(getStatisticSet(), "directory_forwards", "Number of requests forwarded to the owner of a modified line", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_directory_recall_invalidations_=sparta::Counter(getStatisticSet(), "directory_recall_invalidations", "Number of invalidations sent to recall the lines of the directory entries evicted to make room", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_directory_broadcasts_=sparta::Counter(getStatisticSet(), "directory_broadcasts", "Number of requests whose invalidations were broadcast because the directory entry had overflowed", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_first_touch_pages_=sparta::Counter(getStatisticSet(), "first_touch_pages", "Number of pages placed in the tile by the first_touch tile_policy", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_shared_pages_=sparta::Counter(getStatisticSet(), "first_touch_shared_pages", "Number of pages interleaved among the tiles because the tile accessed them after they were placed in a different tile", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_dnuca_migrations_=sparta::Counter(getStatisticSet(), "dnuca_migrations", "Number of lines that migrated from the tile to a tile that kept hitting on them", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_dnuca_replications_=sparta::Counter(getStatisticSet(), "dnuca_replications", "Number of read-only lines of the tile replicated in a tile that kept hitting on them", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_dnuca_replica_requests_=sparta::Counter(getStatisticSet(), "dnuca_replica_requests", "Number of requests of the local cores sent to the local replica of a line", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_dnuca_replica_invalidations_=sparta::Counter(getStatisticSet(), "dnuca_replica_invalidations", "Number of replicas invalidated by writes of the local cores", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_dnuca_forwarded_requests_=sparta::Counter(getStatisticSet(), "dnuca_forwarded_requests", "Number of requests forwarded by the tile to the tile that holds their migrated line", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_coherence_acks_=sparta::Counter(getStatisticSet(), "coherence_acks", "Number of acknowledgements of invalidations and forwards received by the directory slice of the tile", sparta::Counter::COUNT_NORMAL);
+            sparta::Counter count_coherence_wait_cycles_=sparta::Counter(getStatisticSet(), "coherence_wait_cycles", "Number of cycles that the misses of the tile waited for the directory to grant them before accessing memory", sparta::Counter::COUNT_NORMAL);
 
             uint64_t cntr;
             uint64_t l2_bank_size_kbs;
@@ -266,7 +325,7 @@ namespace coyote
             std::shared_ptr<FullSystemSimulationEventManager> request_manager_;
 
             /*!
-             * \brief Send a request to a memory controller
+             * \brief Send a request to a memory controller. If the L2 is coherent, the directory is notified first
              * \param req The request
              */
             void issueMemoryControllerRequestFromL2_(const std::shared_ptr<CacheRequest> & req);
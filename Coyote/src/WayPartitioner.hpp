@@ -0,0 +1,178 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __WAY_PARTITIONER_HH__
+#define __WAY_PARTITIONER_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "sparta/utils/SpartaAssert.hpp"
+#include "CacheRequest.hpp"
+
+namespace coyote
+{
+    /*!
+     * \class coyote::WayPartitioner
+     * \brief Assigns the ways of a cache bank to the cores or tiles that share it.
+     *
+     * Each configured core (or tile) gets a partition with a mask of the ways in which its lines
+     * may be allocated. Partition 0 holds the requests of the cores that are not configured, which
+     * may use all the ways, and the writebacks when partitioning by core, as their core is unknown.
+     * Masks are given as "id:mask" and the mask may be written in hexadecimal (e.g. "3:0xF0").
+     */
+    class WayPartitioner
+    {
+        public:
+            enum class Mode
+            {
+                NONE,
+                CORE,
+                TILE
+            };
+
+            /*!
+            * \brief Constructor for WayPartitioner
+            * \param mode How requests are assigned to partitions (none, core, tile)
+            * \param masks The initial mask of each partition, as "id:mask"
+            * \param associativity The number of ways of the bank (at most 64 if partitioning is enabled)
+            */
+            WayPartitioner(const std::string& mode, const std::vector<std::string>& masks, uint64_t associativity) :
+                mode_(Mode::NONE),
+                all_ways_(associativity>=64 ? UINT64_MAX : (uint64_t(1) << associativity)-1),
+                ids_(),
+                masks_(1, all_ways_)
+            {
+                sparta_assert(mode=="none" || mode=="core" || mode=="tile", "The way_partitioning of the cache banks must be none, core or tile");
+                if(mode=="core")
+                {
+                    mode_=Mode::CORE;
+                }
+                else if(mode=="tile")
+                {
+                    mode_=Mode::TILE;
+                }
+                sparta_assert(mode_==Mode::NONE || associativity<=64, "Way partitioning supports up to 64 ways");
+                sparta_assert(mode_!=Mode::NONE || masks.empty(), "Way partition masks require way_partitioning to be core or tile");
+
+                for(const std::string& m : masks)
+                {
+                    size_t sep=m.find(":");
+                    sparta_assert(sep!=std::string::npos, "Way partition masks must be id:mask, got " << m);
+                    uint16_t id=std::stoul(m.substr(0, sep));
+                    sparta_assert(find_(id)==0, "Way partition " << id << " is defined twice");
+                    ids_.push_back(id);
+                    masks_.push_back(0);
+                    setMask(id, std::stoull(m.substr(sep+1), nullptr, 0));
+                }
+            }
+
+            bool enabled() const
+            {
+                return mode_!=Mode::NONE;
+            }
+
+            /*!
+            * \brief Get the number of partitions, including partition 0
+            * \return The number of partitions
+            */
+            size_t size() const
+            {
+                return masks_.size();
+            }
+
+            /*!
+            * \brief Get the partition of a request
+            * \param req The request
+            * \return The partition (0 if the requesting core or tile is not configured)
+            */
+            uint16_t getPartition(const std::shared_ptr<CacheRequest>& req) const
+            {
+                if(mode_==Mode::NONE || (mode_==Mode::CORE && req->getType()==CacheRequest::AccessType::WRITEBACK))
+                {
+                    return 0;
+                }
+                return find_(mode_==Mode::CORE ? req->getCoreId() : req->getSourceTile());
+            }
+
+            uint64_t getMask(uint16_t partition) const
+            {
+                return masks_[partition];
+            }
+
+            /*!
+            * \brief Change the mask of a configured core or tile. Lines already allocated outside the new mask stay until they are replaced
+            * \param id The core or tile
+            * \param mask The ways in which its lines may be allocated
+            */
+            void setMask(uint16_t id, uint64_t mask)
+            {
+                uint16_t partition=find_(id);
+                sparta_assert(partition!=0, "Way partition " << id << " is not configured");
+                sparta_assert(mask!=0 && (mask & ~all_ways_)==0, "The way partition mask of " << id << " must select ways of the bank");
+                masks_[partition]=mask;
+            }
+
+            /*!
+            * \brief Add a core or tile with access to all the ways, unless it is already configured
+            * \param id The core or tile
+            */
+            void addPartition(uint16_t id)
+            {
+                if(find_(id)==0)
+                {
+                    ids_.push_back(id);
+                    masks_.push_back(all_ways_);
+                }
+            }
+
+            /*!
+            * \brief Get the name of a partition, used to name its statistics
+            * \param partition The partition
+            * \return The name (e.g. core3 or tile1, other for partition 0)
+            */
+            std::string getName(uint16_t partition) const
+            {
+                if(partition==0)
+                {
+                    return "other";
+                }
+                return (mode_==Mode::CORE ? "core" : "tile") + std::to_string(ids_[partition-1]);
+            }
+
+        private:
+            Mode mode_;
+            uint64_t all_ways_;
+            std::vector<uint16_t> ids_;   //! The core or tile of partition i+1
+            std::vector<uint64_t> masks_; //! The mask of each partition
+
+            uint16_t find_(uint16_t id) const
+            {
+                for(size_t i=0; i<ids_.size(); i++)
+                {
+                    if(ids_[i]==id)
+                    {
+                        return i+1;
+                    }
+                }
+                return 0;
+            }
+    };
+}
+#endif
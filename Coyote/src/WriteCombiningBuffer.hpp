@@ -0,0 +1,206 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#ifndef __WRITE_COMBINING_BUFFER_HH__
+#define __WRITE_COMBINING_BUFFER_HH__
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "sparta/utils/SpartaAssert.hpp"
+#include "CacheRequest.hpp"
+
+namespace coyote
+{
+    /*!
+     * \class coyote::WriteCombiningBuffer
+     * \brief A small fully-associative buffer that merges the stores to the same line
+     * so a write-through cache sends a single write per line to the next level.
+     *
+     * Entries are kept in allocation order, so the oldest one is always at the front.
+     * The bytes written to each line are tracked in up to 64 sectors. Stores without a
+     * known size are merged, but the line is then never considered fully written, and the
+     * combined write is assumed to cover the whole line.
+     */
+    class WriteCombiningBuffer
+    {
+        public:
+            struct Entry
+            {
+                uint64_t line;                      //! Address of the line
+                uint64_t allocation_cycle;          //! Cycle in which the first store to the line was buffered
+                std::shared_ptr<CacheRequest> req;  //! The first store to the line, used as a template for the combined write
+                uint64_t written_sectors;           //! Bitmask of the sectors written by the merged stores
+                bool unknown_size;                  //! Whether any of the merged stores did not carry its size
+            };
+
+            /*!
+            * \brief Constructor for WriteCombiningBuffer
+            * \param num_entries The number of lines that can be buffered (0 disables the buffer)
+            * \param line_size The size of a line in bytes
+            */
+            WriteCombiningBuffer(uint16_t num_entries, uint64_t line_size) :
+                num_entries_(num_entries),
+                line_size_(line_size),
+                sector_size_(line_size>64 ? line_size/64 : 1),
+                num_sectors_(line_size/sector_size_),
+                full_mask_(num_sectors_>=64 ? UINT64_MAX : (uint64_t(1) << num_sectors_)-1),
+                entries_()
+            {
+                entries_.reserve(num_entries);
+            }
+
+            bool enabled() const
+            {
+                return num_entries_>0;
+            }
+
+            bool isFull() const
+            {
+                return entries_.size()==num_entries_;
+            }
+
+            bool empty() const
+            {
+                return entries_.empty();
+            }
+
+            size_t size() const
+            {
+                return entries_.size();
+            }
+
+            /*!
+            * \brief Get the address of the line of an address
+            * \param address The address
+            * \return The address of the first byte of its line
+            */
+            uint64_t getLine(uint64_t address) const
+            {
+                return (address/line_size_)*line_size_;
+            }
+
+            bool contains(uint64_t line) const
+            {
+                return find_(line)!=entries_.end();
+            }
+
+            /*!
+            * \brief Merge a store into the entry of its line, if there is one
+            * \param req The store
+            * \return True if the store was merged, false if its line is not buffered
+            */
+            bool merge(const std::shared_ptr<CacheRequest>& req)
+            {
+                auto it=find_(getLine(req->getAddress()));
+                if(it==entries_.end())
+                {
+                    return false;
+                }
+                markWritten_(*it, req);
+                return true;
+            }
+
+            /*!
+            * \brief Allocate a new entry for the line of a store
+            * \param req The store
+            * \param cycle The current cycle
+            * \note The buffer must not be full and the line must not be buffered
+            */
+            void allocate(const std::shared_ptr<CacheRequest>& req, uint64_t cycle)
+            {
+                sparta_assert(!isFull(), "Allocating in a full write-combining buffer");
+                entries_.push_back(Entry{getLine(req->getAddress()), cycle, req, 0, false});
+                markWritten_(entries_.back(), req);
+            }
+
+            const Entry& oldest() const
+            {
+                sparta_assert(!entries_.empty(), "Oldest entry of an empty write-combining buffer");
+                return entries_.front();
+            }
+
+            /*!
+            * \brief Remove the entry of a line
+            * \param line The address of the line
+            * \return The removed entry
+            */
+            Entry remove(uint64_t line)
+            {
+                auto it=find_(line);
+                sparta_assert(it!=entries_.end(), "Removing a line that is not in the write-combining buffer");
+                Entry e=*it;
+                entries_.erase(it);
+                return e;
+            }
+
+            /*!
+            * \brief Get the number of bytes of a line written by the stores merged in an entry
+            * \param e The entry
+            * \return The number of bytes, or the size of a line if the size of any of the stores is unknown
+            */
+            uint64_t getWrittenBytes(const Entry& e) const
+            {
+                if(e.unknown_size)
+                {
+                    return line_size_;
+                }
+                return __builtin_popcountll(e.written_sectors)*sector_size_;
+            }
+
+            bool isFullyWritten(const Entry& e) const
+            {
+                return !e.unknown_size && e.written_sectors==full_mask_;
+            }
+
+        private:
+            uint16_t num_entries_;
+            uint64_t line_size_;
+            uint64_t sector_size_;
+            uint64_t num_sectors_;
+            uint64_t full_mask_;
+            std::vector<Entry> entries_; //! In allocation order
+
+            std::vector<Entry>::iterator find_(uint64_t line)
+            {
+                return std::find_if(entries_.begin(), entries_.end(), [line](const Entry& e){ return e.line==line; });
+            }
+
+            std::vector<Entry>::const_iterator find_(uint64_t line) const
+            {
+                return std::find_if(entries_.begin(), entries_.end(), [line](const Entry& e){ return e.line==line; });
+            }
+
+            void markWritten_(Entry& e, const std::shared_ptr<CacheRequest>& req)
+            {
+                if(req->getSize()==0)
+                {
+                    e.unknown_size=true;
+                    return;
+                }
+                uint64_t first=(req->getAddress()-e.line)/sector_size_;
+                uint64_t end=std::min((req->getAddress()-e.line+req->getSize()+sector_size_-1)/sector_size_, num_sectors_);
+                for(uint64_t s=first; s<end; s++)
+                {
+                    e.written_sectors|=uint64_t(1) << s;
+                }
+            }
+    };
+}
+#endif
@@ -0,0 +1,54 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#pragma once
+
+#include "cache/ReplacementIF.hpp"
+
+namespace sparta
+{
+
+    namespace cache
+    {
+
+        /**
+         * \class AccessAwareReplacementIF
+         *
+         * Replacement policies that need to tell hits from fills, or to know the set
+         * and the PC of the access. SimpleCache uses touchOnHit/touchOnFill instead of
+         * touchMRU when the policy of the cache implements this interface.
+         */
+        class AccessAwareReplacementIF : public ReplacementIF
+        {
+        public:
+            AccessAwareReplacementIF(uint32_t num_ways) : ReplacementIF(num_ways) {}
+
+            virtual ~AccessAwareReplacementIF() {}
+
+            // Update the state of a way after a hit of the instruction at pc
+            virtual void touchOnHit(uint32_t way, uint32_t set_idx, uint64_t pc) = 0;
+
+            // Update the state of a way after it has been filled on a miss of the instruction at pc
+            virtual void touchOnFill(uint32_t way, uint32_t set_idx, uint64_t pc) = 0;
+        };
+
+    }; // namespace cache
+
+}; // namespace sparta
@@ -22,6 +22,9 @@
 #pragma once
 
 #include <vector>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
 #include "sparta/utils/MathUtils.hpp"
 #include "cache/BasicCacheItem.hpp"
 #include "cache/ReplacementIF.hpp"
@@ -32,6 +35,16 @@ namespace sparta
 
     namespace cache {
 
+        /**
+         * \class BasicCacheSet
+         *
+         * The tags and valid bits of the ways are also kept in contiguous arrays
+         * (structure of arrays), so lookups compare several tags at once using
+         * AVX2/SSE4.1 when available, or a scalar loop otherwise. The items keep the
+         * rest of the line metadata (dirty, accessed by vector/non-vector...).
+         * Any change to the tag or the valid bit of an item must be followed by
+         * syncWay, as done by SimpleCache.
+         */
         template <class CacheItemT>
         class BasicCacheSet
         {
@@ -51,11 +64,14 @@ namespace sparta
                 replacement_policy_ = rep.clone();
 
                 ways_.resize(num_ways, default_line);
+                tags_.resize(num_ways, 0);
+                valid_bits_.resize((num_ways+63)/64, 0);
 
                 for (uint32_t i=0; i<num_ways; ++i) {
                     ways_[i].setSetIndex(set_idx_);
                     ways_[i].setWayNum(i);
                     ways_[i].setAddrDecoder(addr_decoder);
+                    syncWay(i);
                 }
             }
 
@@ -64,7 +80,9 @@ namespace sparta
                 set_idx_(rhs.set_idx_),
                 num_ways_(rhs.num_ways_),
                 replacement_policy_(rhs.replacement_policy_->clone()),
-                ways_(rhs.ways_)
+                ways_(rhs.ways_),
+                tags_(rhs.tags_),
+                valid_bits_(rhs.valid_bits_)
             {
             }
 
@@ -73,8 +91,11 @@ namespace sparta
             {
                 if ( this != &rhs ) {
                     num_ways_ = rhs.num_ways_;
+                    delete replacement_policy_;
                     replacement_policy_ = rhs.replacement_policy_->clone();
                     ways_ = rhs.ways_;
+                    tags_ = rhs.tags_;
+                    valid_bits_ = rhs.valid_bits_;
                 }
 
                 return *this;
@@ -104,20 +125,62 @@ namespace sparta
                 return replacement_policy_;
             }
 
+            // Copy the tag and the valid bit of an item to the tag arrays.
+            // Must be called every time the item is (re)allocated or invalidated.
+            void syncWay(uint32_t way_idx)
+            {
+                const uint64_t bit = uint64_t(1) << (way_idx % 64);
+                tags_[way_idx] = ways_[way_idx].getTag();
+                if ( ways_[way_idx].isValid() ) {
+                    valid_bits_[way_idx / 64] |= bit;
+                }
+                else {
+                    valid_bits_[way_idx / 64] &= ~bit;
+                }
+            }
+
+            // Get the way of the valid item with the given tag.
+            // num_ways_ is returned if there is no such item.
+            uint32_t findWay(uint64_t tag) const
+            {
+                const uint64_t *tags = tags_.data();
+                uint32_t i = 0;
+#if defined(__AVX2__)
+                const __m256i key = _mm256_set1_epi64x(static_cast<long long>(tag));
+                for (; i+4<=num_ways_; i+=4) {
+                    const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags + i));
+                    uint64_t match = static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(t, key))));
+                    match &= validBitsAt_(i) & 0xF;
+                    if ( match ) {
+                        return i + __builtin_ctzll(match);
+                    }
+                }
+#elif defined(__SSE4_1__)
+                const __m128i key = _mm_set1_epi64x(static_cast<long long>(tag));
+                for (; i+2<=num_ways_; i+=2) {
+                    const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags + i));
+                    uint64_t match = static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(t, key))));
+                    match &= validBitsAt_(i) & 0x3;
+                    if ( match ) {
+                        return i + __builtin_ctzll(match);
+                    }
+                }
+#endif
+                for (; i<num_ways_; ++i) {
+                    if ( (validBitsAt_(i) & 0x1) && (tags[i] == tag) ) {
+                        return i;
+                    }
+                }
+                return num_ways_;
+            }
+
             // Get the const pointer to the item in the cache set given
             // the tag.  If no valid item with matching tag is found
             // nullptr is returned.
             CacheItemT *peekItem(uint64_t tag)
             {
-                CacheItemT *line = nullptr;
-                for (uint32_t i=0;i<num_ways_; ++i) {
-                    if ( ways_[i].isValid() &&
-                         (ways_[i].getTag() == tag) ) {
-                        line = &ways_[i];
-                        break;
-                    }
-                }
-                return line;
+                uint32_t way = findWay(tag);
+                return (way < num_ways_) ? &ways_[way] : nullptr;
             }
 
             // Get the pointer to the item in the cache set given
@@ -125,16 +188,8 @@ namespace sparta
             // nullptr is returned.
             CacheItemT *getItem(uint64_t tag)
             {
-                CacheItemT *line = nullptr;
-                for (uint32_t i=0;i<num_ways_; ++i) {
-                    if ( ways_[i].isValid() ) {
-                        if  ( ways_[i].getTag() == tag ) {
-                            line = &ways_[i];
-                            break;
-                        }
-                    }
-                }
-                return line;
+                uint32_t way = findWay(tag);
+                return (way < num_ways_) ? &ways_[way] : nullptr;
             }
 
 
@@ -142,21 +197,13 @@ namespace sparta
             // also determines (for misses) whether it was cold i.e. cache had invalid line(s)
             CacheItemT *getItem(uint64_t tag, bool &is_cold_miss)
             {
-                CacheItemT *line = nullptr;
-                is_cold_miss = false;
-                for (uint32_t i=0;i<num_ways_; ++i) {
-                    if ( ways_[i].isValid() ) {
-                        if ( ways_[i].getTag() == tag ) {
-                            line = &ways_[i];
-                            is_cold_miss = false;
-                            break;
-                        }
-                    }
-                    else {
-                        is_cold_miss = true;
-                    }
+                uint32_t way = findWay(tag);
+                if ( way < num_ways_ ) {
+                    is_cold_miss = false;
+                    return &ways_[way];
                 }
-                return line;
+                is_cold_miss = hasOpenWay();
+                return nullptr;
             }
 
 
@@ -209,10 +256,13 @@ namespace sparta
 
             uint32_t findInvalidWay() const
             {
-                for (uint32_t i=0;i<num_ways_; ++i) {
-
-                    if ( ! ways_[i].isValid() ) {
-                        return i;
+                for (uint32_t i=0; i<num_ways_; i+=64) {
+                    uint64_t invalid = ~valid_bits_[i / 64];
+                    if ( num_ways_ - i < 64 ) {
+                        invalid &= (uint64_t(1) << (num_ways_ - i)) - 1;
+                    }
+                    if ( invalid ) {
+                        return i + __builtin_ctzll(invalid);
                     }
                 }
                 return num_ways_;
@@ -241,10 +291,18 @@ namespace sparta
             const_iterator begin() const { return ways_.begin(); }
             const_iterator end()   const { return ways_.end(); }
         protected:
+            // Get the valid bits of the ways starting at way_idx (up to the end of its 64-way word)
+            uint64_t validBitsAt_(uint32_t way_idx) const
+            {
+                return valid_bits_[way_idx / 64] >> (way_idx % 64);
+            }
+
             const uint32_t          set_idx_;
             uint32_t          num_ways_;
             ReplacementIF          *replacement_policy_;
             std::vector<CacheItemT> ways_;
+            std::vector<uint64_t>   tags_;        // Tag of each way
+            std::vector<uint64_t>   valid_bits_;  // Valid bit of each way, 64 ways per word
         }; // class Cache
 
     }; // namespace cache
@@ -22,6 +22,8 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <iterator>
 #include "sparta/utils/MathUtils.hpp"
 #include "cache/AddrDecoderIF.hpp"
 #include "cache/DefaultAddrDecoder.hpp"
@@ -34,12 +36,64 @@ namespace sparta
 
         class ReplacementIF;
 
+        /**
+         * \class Cache
+         *
+         * The storage of a set is allocated the first time the set is touched,
+         * so the memory footprint and the construction time of the cache scale
+         * with the working set instead of the configured capacity. A set that has
+         * never been touched behaves as a set with all its ways invalid.
+         * Iterators only visit the sets that have been allocated.
+         */
         template< class CacheItemT, class CacheSetT=BasicCacheSet<CacheItemT> >
         class Cache
         {
+            template< class SetT, class SetPtrIteratorT >
+            class AllocatedSetIterator
+            {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef SetT                      value_type;
+                typedef std::ptrdiff_t            difference_type;
+                typedef SetT*                     pointer;
+                typedef SetT&                     reference;
+
+                AllocatedSetIterator(SetPtrIteratorT it, SetPtrIteratorT end) :
+                    it_(it), end_(end)
+                {
+                    skipUnallocated_();
+                }
+
+                reference operator*() const { return **it_; }
+                pointer operator->() const { return it_->get(); }
+
+                AllocatedSetIterator &operator++()
+                {
+                    ++it_;
+                    skipUnallocated_();
+                    return *this;
+                }
+
+                bool operator==(const AllocatedSetIterator &rhs) const { return it_ == rhs.it_; }
+                bool operator!=(const AllocatedSetIterator &rhs) const { return it_ != rhs.it_; }
+
+            private:
+                void skipUnallocated_()
+                {
+                    while (it_ != end_ && *it_ == nullptr) {
+                        ++it_;
+                    }
+                }
+
+                SetPtrIteratorT it_;
+                SetPtrIteratorT end_;
+            };
+
+            typedef std::vector<std::unique_ptr<CacheSetT>> SetStorage;
+
         public:
-            typedef typename std::vector<CacheSetT>::iterator       iterator;
-            typedef typename std::vector<CacheSetT>::const_iterator const_iterator;
+            typedef AllocatedSetIterator<CacheSetT, typename SetStorage::iterator>             iterator;
+            typedef AllocatedSetIterator<const CacheSetT, typename SetStorage::const_iterator> const_iterator;
 
             Cache( uint64_t cache_sz,
                    uint64_t item_sz,
@@ -48,7 +102,10 @@ namespace sparta
                    const ReplacementIF &rep,
                    bool cache_sz_unit_is_kb = true) :
                 num_sets_(((cache_sz_unit_is_kb) ? (cache_sz*1024):(cache_sz))/(item_sz*rep.getNumWays())),
-                num_ways_(rep.getNumWays())
+                num_ways_(rep.getNumWays()),
+                default_line_(default_line),
+                rep_(rep.clone()),
+                sets_(num_sets_)
            {
                 assert( utils::is_power_of_2(item_sz) );
                 assert( utils::is_power_of_2(stride) );
@@ -59,16 +116,6 @@ namespace sparta
                                                                    num_ways_,
                                                                    cache_sz_unit_is_kb));
                 addr_decoder_ = default_addr_decoder_.get();
-
-                for (uint32_t i=0; i<num_sets_; ++i) {
-                    sets_.push_back( CacheSetT( i,
-                                                num_ways_,
-                                                default_line,
-                                                addr_decoder_,
-                                                rep)
-                                     );
-                }
-
            }
 
             /*
@@ -77,8 +124,8 @@ namespace sparta
             void setAddrDecoder(AddrDecoderIF *addr_decoder)
             {
                 addr_decoder_ = addr_decoder;
-                for (uint32_t i=0; i<num_sets_; ++i) {
-                    sets_[i].setAddrDecoder(addr_decoder);
+                for (auto &set : *this) {
+                    set.setAddrDecoder(addr_decoder);
                 }
             }
 
@@ -97,7 +144,7 @@ namespace sparta
             {
                 uint32_t set_idx = addr_decoder_->calcIdx(addr);
                 assert(set_idx < num_sets_);
-                return sets_[set_idx];
+                return allocateSet_(set_idx);
             }
 
             /*
@@ -107,7 +154,7 @@ namespace sparta
             {
                 uint32_t set_idx = addr_decoder_->calcIdx(addr);
                 assert(set_idx < num_sets_);
-                return sets_[set_idx];
+                return allocateSet_(set_idx);
             }
 
             /*
@@ -116,7 +163,7 @@ namespace sparta
             CacheSetT &getCacheSetAtIndex(uint set_idx)
             {
                 assert(set_idx < num_sets_);
-                return sets_[set_idx];
+                return allocateSet_(set_idx);
             }
 
             /*
@@ -125,7 +172,15 @@ namespace sparta
             CacheSetT &peekCacheSetAtIndex(uint set_idx) const
             {
                 assert(set_idx < num_sets_);
-                return sets_[set_idx];
+                return allocateSet_(set_idx);
+            }
+
+            /*
+             * \brief Check if the storage of the set for the given address has been allocated
+             */
+            bool isSetAllocated(uint64_t addr) const
+            {
+                return sets_[addr_decoder_->calcIdx(addr)] != nullptr;
             }
 
             /*!
@@ -145,6 +200,10 @@ namespace sparta
              */
             CacheItemT *peekItem(uint64_t addr)
             {
+                // An untouched set has no valid items, do not allocate it
+                if (!isSetAllocated(addr)) {
+                    return nullptr;
+                }
                 uint64_t tag     = addr_decoder_->calcTag(addr);
                 return peekCacheSet(addr).peekItem(tag);
             }
@@ -158,7 +217,7 @@ namespace sparta
             CacheItemT &getItemAtIndexWay(uint32_t set_idx, uint32_t way)
             {
                 assert(set_idx < num_sets_);
-                return sets_[set_idx].getItemAtWay(way);
+                return allocateSet_(set_idx).getItemAtWay(way);
             }
 
             /*!
@@ -190,9 +249,41 @@ namespace sparta
 
             uint32_t findInvalidWay(uint64_t addr) const
             {
+                if (!isSetAllocated(addr)) {
+                    return 0;
+                }
                 return peekCacheSet(addr).findInvalidWay();
             }
 
+            /*
+             * \brief Disable ways in all the sets, including the ones that are allocated later
+             */
+            void disableWays(uint64_t ways_to_disable)
+            {
+                disabled_ways_ += ways_to_disable;
+                for (auto &set : *this) {
+                    set.disableWays(ways_to_disable);
+                }
+            }
+
+            /*
+             * \brief Enable ways in all the sets, including the ones that are allocated later
+             */
+            void enableWays(uint64_t ways_to_enable)
+            {
+                disabled_ways_ -= ways_to_enable;
+                for (auto &set : *this) {
+                    set.enableWays(ways_to_enable);
+                }
+            }
+
+            /*
+             * \brief Get the number of sets whose storage has been allocated
+             */
+            uint32_t getNumAllocatedSets() const {
+                return num_allocated_sets_;
+            }
+
             uint32_t getNumWays() const {
                 return num_ways_;
             }
@@ -201,20 +292,42 @@ namespace sparta
                 return num_sets_;
             }
 
-            iterator       begin() { return sets_.begin(); }
-            iterator       end()   { return sets_.end(); }
-            const_iterator begin() const { return sets_.begin(); }
-            const_iterator end()   const { return sets_.end(); }
+            iterator       begin() { return iterator(sets_.begin(), sets_.end()); }
+            iterator       end()   { return iterator(sets_.end(), sets_.end()); }
+            const_iterator begin() const { return const_iterator(sets_.cbegin(), sets_.cend()); }
+            const_iterator end()   const { return const_iterator(sets_.cend(), sets_.cend()); }
         private:
             Cache(const Cache &rhs);
             Cache &operator=(const Cache &rhs);
 
+            /*
+             * \brief Get the set at the given index, allocating its storage on its first touch
+             */
+            CacheSetT &allocateSet_(uint32_t set_idx) const
+            {
+                std::unique_ptr<CacheSetT> &set = sets_[set_idx];
+                if (set == nullptr) {
+                    set.reset(new CacheSetT(set_idx,
+                                            num_ways_,
+                                            default_line_,
+                                            addr_decoder_,
+                                            *rep_));
+                    set->disableWays(disabled_ways_);
+                    ++num_allocated_sets_;
+                }
+                return *set;
+            }
+
             std::unique_ptr<DefaultAddrDecoder> default_addr_decoder_;
             AddrDecoderIF   * addr_decoder_ = nullptr;
 
             const uint32_t                      num_sets_;
             const uint32_t                      num_ways_;
-            std::vector<CacheSetT>  sets_;
+            const CacheItemT                    default_line_;  // Item used to initialize the ways of new sets
+            std::unique_ptr<ReplacementIF>      rep_;           // Replacement policy cloned by new sets
+            uint64_t                            disabled_ways_ = 0;
+            mutable SetStorage                  sets_;          // Sets are allocated on their first touch
+            mutable uint32_t                    num_allocated_sets_ = 0;
 
         }; // class Cache
 
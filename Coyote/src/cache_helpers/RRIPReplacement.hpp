@@ -0,0 +1,295 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "sparta/utils/SpartaAssert.hpp"
+#include "AccessAwareReplacementIF.hpp"
+
+namespace sparta
+{
+
+    namespace cache
+    {
+
+        /**
+         * \class SRRIPReplacement
+         *
+         * Static Re-Reference Interval Prediction (Jaleel et al., ISCA 2010) with 2-bit
+         * re-reference prediction values (RRPV). Lines are inserted with a long re-reference
+         * interval (MAX_RRPV-1) and promoted to 0 on hits. The victim is the first way with
+         * the largest RRPV; the aging of the set (until the victim has a distant MAX_RRPV
+         * prediction) is applied when the victim is filled, so getLRUWay does not modify
+         * the state of the set.
+         */
+        class SRRIPReplacement : public AccessAwareReplacementIF
+        {
+        public:
+            static constexpr uint8_t MAX_RRPV = 3;
+
+            SRRIPReplacement(uint32_t num_ways) :
+                AccessAwareReplacementIF(num_ways),
+                rrpv_(num_ways, MAX_RRPV)
+            {}
+
+            ReplacementIF *clone() const { return new SRRIPReplacement(*this); }
+
+            void reset()
+            {
+                std::fill(rrpv_.begin(), rrpv_.end(), MAX_RRPV);
+            }
+
+            uint32_t getLRUWay() const
+            {
+                return std::max_element(rrpv_.begin(), rrpv_.end()) - rrpv_.begin();
+            }
+
+            uint32_t getMRUWay() const
+            {
+                return std::min_element(rrpv_.begin(), rrpv_.end()) - rrpv_.begin();
+            }
+
+            void touchLRU(uint32_t way)
+            {
+                rrpv_[way] = MAX_RRPV;
+            }
+
+            void touchLRU(uint32_t way, const std::vector<uint32_t> &)
+            {
+                touchLRU(way);
+            }
+
+            void touchMRU(uint32_t way)
+            {
+                rrpv_[way] = 0;
+            }
+
+            void touchMRU(uint32_t way, const std::vector<uint32_t> &)
+            {
+                touchMRU(way);
+            }
+
+            void lockWay(uint32_t)
+            {
+                sparta_assert(false, "Way locking is not supported by the RRIP replacement policies");
+            }
+
+            void touchOnHit(uint32_t way, uint32_t, uint64_t)
+            {
+                rrpv_[way] = 0;
+            }
+
+            void touchOnFill(uint32_t way, uint32_t set_idx, uint64_t pc)
+            {
+                // Age the set until the replaced way has a distant prediction
+                const uint8_t aging = MAX_RRPV - rrpv_[way];
+                if ( aging > 0 ) {
+                    for (auto &r : rrpv_) {
+                        r = std::min<uint8_t>(r + aging, MAX_RRPV);
+                    }
+                }
+                rrpv_[way] = getInsertionRRPV_(set_idx, pc);
+            }
+
+        protected:
+            // The RRPV of a line inserted on a miss in set set_idx of the instruction at pc
+            virtual uint8_t getInsertionRRPV_(uint32_t, uint64_t)
+            {
+                return MAX_RRPV - 1;
+            }
+
+            std::vector<uint8_t> rrpv_;
+        };
+
+        /**
+         * \class BRRIPReplacement
+         *
+         * Bimodal RRIP. Most lines are inserted with a distant re-reference prediction,
+         * and one out of every BIMODAL_THROTTLE fills with a long one, which protects part
+         * of the working set from thrashing. The fill count is shared by all the sets of
+         * the cache so that the insertion pattern is deterministic.
+         */
+        class BRRIPReplacement : public SRRIPReplacement
+        {
+        public:
+            static constexpr uint32_t BIMODAL_THROTTLE = 32;
+
+            BRRIPReplacement(uint32_t num_ways) :
+                SRRIPReplacement(num_ways),
+                fills_(std::make_shared<uint32_t>(0))
+            {}
+
+            ReplacementIF *clone() const { return new BRRIPReplacement(*this); }
+
+        protected:
+            uint8_t getInsertionRRPV_(uint32_t, uint64_t)
+            {
+                return bimodalRRPV_(fills_);
+            }
+
+            static uint8_t bimodalRRPV_(const std::shared_ptr<uint32_t> &fills)
+            {
+                *fills = (*fills + 1) % BIMODAL_THROTTLE;
+                return (*fills == 0) ? MAX_RRPV - 1 : MAX_RRPV;
+            }
+
+            std::shared_ptr<uint32_t> fills_;
+        };
+
+        /**
+         * \class DRRIPReplacement
+         *
+         * Dynamic RRIP. Set dueling between SRRIP and BRRIP: in each constituency of
+         * DUELING_INTERVAL sets, one leader set always uses SRRIP and another one always
+         * uses BRRIP. Misses in the leaders update a saturating policy selector (PSEL) that is
+         * shared by all the sets of the cache, and follower sets use the policy that
+         * is missing less.
+         */
+        class DRRIPReplacement : public BRRIPReplacement
+        {
+        public:
+            static constexpr uint32_t DUELING_INTERVAL = 32;
+            static constexpr uint32_t PSEL_MAX = 1023; // 10-bit selector
+
+            DRRIPReplacement(uint32_t num_ways) :
+                BRRIPReplacement(num_ways),
+                psel_(std::make_shared<uint32_t>(PSEL_MAX/2 + 1))
+            {}
+
+            ReplacementIF *clone() const { return new DRRIPReplacement(*this); }
+
+        protected:
+            uint8_t getInsertionRRPV_(uint32_t set_idx, uint64_t)
+            {
+                // Complement-select: the leaders of constituency c are the sets at offsets c and (DUELING_INTERVAL-1-c)
+                const uint32_t offset = set_idx % DUELING_INTERVAL;
+                const uint32_t constituency = (set_idx / DUELING_INTERVAL) % DUELING_INTERVAL;
+                bool use_srrip;
+                if ( offset == constituency ) {
+                    *psel_ = std::min(*psel_ + 1, PSEL_MAX);
+                    use_srrip = true;
+                }
+                else if ( offset == DUELING_INTERVAL - 1 - constituency ) {
+                    *psel_ = (*psel_ > 0) ? *psel_ - 1 : 0;
+                    use_srrip = false;
+                }
+                else {
+                    use_srrip = *psel_ <= PSEL_MAX/2;
+                }
+                return use_srrip ? MAX_RRPV - 1 : bimodalRRPV_(fills_);
+            }
+
+            std::shared_ptr<uint32_t> psel_;
+        };
+
+        /**
+         * \class SHiPReplacement
+         *
+         * Signature-based Hit Predictor (Wu et al., MICRO 2011) on top of SRRIP. Each line
+         * remembers the signature (a hash of the PC) of the instruction that brought it
+         * and whether it has been reused. A table of saturating counters (SHCT) shared by
+         * all the sets is incremented on hits and decremented when a line is evicted without
+         * reuse. Lines whose signature has a zero counter are inserted with a distant
+         * re-reference prediction.
+         */
+        class SHiPReplacement : public SRRIPReplacement
+        {
+        public:
+            static constexpr uint32_t SIGNATURE_BITS = 14;
+            static constexpr uint8_t SHCT_MAX = 7; // 3-bit counters
+
+            SHiPReplacement(uint32_t num_ways) :
+                SRRIPReplacement(num_ways),
+                shct_(std::make_shared<std::vector<uint8_t>>(1 << SIGNATURE_BITS, 1)),
+                signature_(num_ways, 0),
+                reused_(num_ways, false),
+                filled_(num_ways, false)
+            {}
+
+            ReplacementIF *clone() const { return new SHiPReplacement(*this); }
+
+            void reset()
+            {
+                SRRIPReplacement::reset();
+                std::fill(reused_.begin(), reused_.end(), false);
+                std::fill(filled_.begin(), filled_.end(), false);
+            }
+
+            void touchLRU(uint32_t way)
+            {
+                SRRIPReplacement::touchLRU(way);
+                filled_[way] = false;
+            }
+
+            void touchLRU(uint32_t way, const std::vector<uint32_t> &)
+            {
+                touchLRU(way);
+            }
+
+            void touchOnHit(uint32_t way, uint32_t set_idx, uint64_t pc)
+            {
+                SRRIPReplacement::touchOnHit(way, set_idx, pc);
+                reused_[way] = true;
+                uint8_t &counter = (*shct_)[signature_[way]];
+                if ( counter < SHCT_MAX ) {
+                    ++counter;
+                }
+            }
+
+            void touchOnFill(uint32_t way, uint32_t set_idx, uint64_t pc)
+            {
+                // The line that is being replaced was never reused
+                if ( filled_[way] && !reused_[way] ) {
+                    uint8_t &counter = (*shct_)[signature_[way]];
+                    if ( counter > 0 ) {
+                        --counter;
+                    }
+                }
+                signature_[way] = getSignature_(pc);
+                reused_[way] = false;
+                filled_[way] = true;
+                SRRIPReplacement::touchOnFill(way, set_idx, pc);
+            }
+
+        protected:
+            uint8_t getInsertionRRPV_(uint32_t, uint64_t pc)
+            {
+                return ((*shct_)[getSignature_(pc)] == 0) ? MAX_RRPV : MAX_RRPV - 1;
+            }
+
+            static uint16_t getSignature_(uint64_t pc)
+            {
+                // Instructions are at least 2-byte aligned
+                const uint64_t h = pc >> 1;
+                return (h ^ (h >> SIGNATURE_BITS) ^ (h >> (2*SIGNATURE_BITS))) & ((1 << SIGNATURE_BITS) - 1);
+            }
+
+            std::shared_ptr<std::vector<uint8_t>> shct_;
+            std::vector<uint16_t> signature_;
+            std::vector<bool> reused_;
+            std::vector<bool> filled_;
+        };
+
+    }; // namespace cache
+
+}; // namespace sparta
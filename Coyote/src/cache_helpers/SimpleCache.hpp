@@ -25,6 +25,7 @@
 #include <sstream>
 #include "Cache.hpp"
 #include "cache/ReplacementIF.hpp"
+#include "AccessAwareReplacementIF.hpp"
 #include "BasicCacheSet.hpp"
 #include "cache/LineData.hpp"
 
@@ -98,7 +99,8 @@ namespace sparta
                        default_line,
                        rep,
                        cache_sz_unit_is_kb),
-                addr_decoder_(cache_.getAddrDecoder())
+                addr_decoder_(cache_.getAddrDecoder()),
+                access_aware_(dynamic_cast<const AccessAwareReplacementIF *>(&rep) != nullptr)
             {
             }
 
@@ -201,6 +203,19 @@ namespace sparta
                 rep->touchMRU( line.getWay() );
             }
 
+            // Update the replacement state after a hit of the instruction at pc.
+            // Equivalent to touchMRU unless the policy is an AccessAwareReplacementIF
+            void touchOnHit(const CacheItemT &line, uint64_t pc)
+            {
+                if ( access_aware_ ) {
+                    auto rep = static_cast<AccessAwareReplacementIF *>(cache_.getCacheSetAtIndex( line.getSetIndex() ).getReplacementIF());
+                    rep->touchOnHit( line.getWay(), line.getSetIndex(), pc );
+                }
+                else {
+                    touchMRU( line );
+                }
+            }
+
             void readWithMRUUpdate(const CacheItemT &line,
                                    uint64_t  addr,
                                    uint32_t  size,
@@ -232,9 +247,27 @@ namespace sparta
                                        uint64_t   addr)
             {
                 line.reset( addr );
+                syncLine_( line );
                 touchMRU( line );
             }
 
+            // Allocate 'line' as having the new 'addr' on a miss of the instruction at 'pc'
+            // The insertion position is decided by the replacement policy
+            void allocateWithFillUpdate(CacheItemT &line,
+                                        uint64_t   addr,
+                                        uint64_t   pc)
+            {
+                line.reset( addr );
+                syncLine_( line );
+                if ( access_aware_ ) {
+                    auto rep = static_cast<AccessAwareReplacementIF *>(cache_.getCacheSetAtIndex( line.getSetIndex() ).getReplacementIF());
+                    rep->touchOnFill( line.getWay(), line.getSetIndex(), pc );
+                }
+                else {
+                    touchMRU( line );
+                }
+            }
+
             // Allocate 'line' as having the new 'addr'
             // 'line' carries the NT state
             void allocateWithMRUUpdate(CacheItemT &line,
@@ -242,6 +275,7 @@ namespace sparta
                                        bool       nt)
             {
                 line.reset( addr );
+                syncLine_( line );
                 if (nt) {
                     auto &cache_set = cache_.getCacheSet(addr);
                     cache_set.setPreviousNTWay( line.getWay() );
@@ -255,6 +289,15 @@ namespace sparta
                 static const bool     nt=false;
                 line.reset( addr, nt );
                 line.setValid( false );
+                syncLine_( line );
+                touchLRU( line );
+            }
+
+            // Invalidate 'line' keeping its address, so it is the next victim of its set
+            void invalidateLine(CacheItemT &line)
+            {
+                line.setValid( false );
+                syncLine_( line );
                 touchLRU( line );
             }
 
@@ -265,6 +308,7 @@ namespace sparta
                     auto line_it = set_it->begin();
                     for (; line_it != set_it->end(); ++line_it) {
                         line_it->setValid(false);
+                        set_it->syncWay(line_it->getWay());
                     }
                     set_it->getReplacementIF()->reset();
 
@@ -300,24 +344,25 @@ namespace sparta
 
             void disableWays(uint64_t ways_to_disable)
             {
-                auto set_it = cache_.begin();
-                for (; set_it != cache_.end(); ++set_it) {
-                    set_it->disableWays(ways_to_disable);
-                }
+                cache_.disableWays(ways_to_disable);
             }
             
             void enableWays(uint64_t ways_to_enable)
             {
-                auto set_it = cache_.begin();
-                for (; set_it != cache_.end(); ++set_it) {
-                    set_it->enableWays(ways_to_enable);
-                }
+                cache_.enableWays(ways_to_enable);
             }
 
         protected:
 
+            // Update the tag arrays of the set of a line after changing its tag or valid bit
+            void syncLine_(const CacheItemT &line)
+            {
+                cache_.getCacheSetAtIndex( line.getSetIndex() ).syncWay( line.getWay() );
+            }
+
             Cache<CacheItemT, CacheSetT> cache_;
             const AddrDecoderIF * const addr_decoder_;
+            const bool access_aware_; // Whether the replacement policy is an AccessAwareReplacementIF
 
          }; // class SimpleCache
 
@@ -95,6 +95,8 @@ void setupTiledSimulation(sparta::app::CommandLineSimulator& cls)
     {
         bank_and_tile_bits *= num_banks;
     }
+    //With first_touch, private pages use every tile bit, so they must stay in the set index and the tag. The lines of shared
+    //pages are interleaved among the tiles with the bits above the bank bits (see SharedL2Director::calculateSharedPageHome_)
     if(tile_policy=="set_interleaving" && sharing=="fully_shared")
     {
         bank_and_tile_bits *= num_tiles;
@@ -174,6 +176,17 @@ std::shared_ptr<SimulationOrchestrator> createExecutionDrivenOrchestrator(sparta
     auto icache_config          = upt.get("top.arch.params.icache_config").getAs<std::string>();
     auto dcache_config          = upt.get("top.arch.params.dcache_config").getAs<std::string>();
 
+    uint64_t cpi_stack_interval=0;
+    std::string cpi_stack_file="cpi_stack.csv";
+    if(upt.hasValue("meta.params.cpi_stack_interval"))
+    {
+        cpi_stack_interval=upt.get("meta.params.cpi_stack_interval").getAs<uint64_t>();
+    }
+    if(upt.hasValue("meta.params.cpi_stack_file"))
+    {
+        cpi_stack_file=upt.get("meta.params.cpi_stack_file").getAs<std::string>();
+    }
+
     sparta_assert(!enable_smart_mcpu || lvrf_ways>0, "At least 1 way in the L2 needs to be used for the LVRF if the MCPU is enabled! Please check parameter lvrf_ways.");
 
     std::shared_ptr<coyote::FullSystemSimulationEventManager> request_manager=sim->createRequestManager();
@@ -217,7 +230,7 @@ std::shared_ptr<SimulationOrchestrator> createExecutionDrivenOrchestrator(sparta
         }
     }
     return std::make_shared<ExecutionDrivenSimulationOrchestrator>(spike, sim, request_manager, num_cores, num_threads_per_core,
-                thread_switch_latency, num_mshrs_per_core, trace, l1_writeback, noc);
+                thread_switch_latency, num_mshrs_per_core, trace, l1_writeback, noc, cpi_stack_interval, cpi_stack_file);
 }
                 
 int main(int argc, char **argv)
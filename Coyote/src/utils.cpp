@@ -50,9 +50,30 @@ namespace utils
                 return "core_finished";
             case StallReason::VECTOR_WAITING_ON_SCALAR_STORE:
                 return "vector_waiting_on_scalar_store";
+            case StallReason::ARBITER_FULL:
+                return "arbiter_full";
             default:
                 return "unknown_reason";
         }
     }
+
+    std::string service_level_to_string(ServiceLevel l)
+    {
+        switch(l)
+        {
+            case ServiceLevel::NONE:
+                return "none";
+            case ServiceLevel::L2:
+                return "l2";
+            case ServiceLevel::REMOTE_L2:
+                return "remote_l2";
+            case ServiceLevel::LLC:
+                return "llc";
+            case ServiceLevel::MEMORY:
+                return "memory";
+            default:
+                return "unknown_level";
+        }
+    }
 }
 
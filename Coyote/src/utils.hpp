@@ -23,12 +23,14 @@
 
 #include <stdint.h>
 #include "StallReason.hpp"
+#include "ServiceLevel.hpp"
 #include <string>
 
 namespace utils 
 {
     uint64_t nextPowerOf2(uint64_t v);
     std::string reason_to_string(StallReason r);
+    std::string service_level_to_string(ServiceLevel l);
 }
 #endif
 
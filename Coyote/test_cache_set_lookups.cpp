@@ -0,0 +1,147 @@
+// 
+// Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+//                Supercomputación
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.
+// See the LICENSE file in the root directory of the project for the
+// specific language governing permissions and limitations under the
+// License.
+// 
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "cache/BasicCacheItem.hpp"
+#include "cache/DefaultAddrDecoder.hpp"
+#include "cache/TreePLRUReplacement.hpp"
+#include "cache_helpers/BasicCacheSet.hpp"
+
+/*
+ * Checks the tag lookups of BasicCacheSet on random access streams. Each lookup is compared with a scan of the
+ * items of the set, and the hit and victim ways of the whole stream are summarized in a hash that is printed
+ * for each configuration. test_cache_set_lookups.sh compares the output of the scalar, SSE4.1 and AVX2 builds.
+ */
+
+class CheckedLine : public sparta::cache::BasicCacheItem
+{
+    public:
+        bool isValid() const {return valid_;}
+        void setValid(bool valid) {valid_=valid;}
+
+    private:
+        bool valid_=false;
+};
+
+using CheckedSet=sparta::cache::BasicCacheSet<CheckedLine>;
+
+static const uint64_t LINE_SIZE=64;
+static const uint32_t ACCESSES=200000;
+
+// Way of the valid item with the given tag, found by scanning the items
+static uint32_t scanWay(CheckedSet& set, uint32_t enabled_ways, uint64_t tag)
+{
+    for(uint32_t w=0; w<enabled_ways; w++)
+    {
+        CheckedLine& line=set.getItemAtWay(w);
+        if(line.isValid() && line.getTag()==tag)
+        {
+            return w;
+        }
+    }
+    return enabled_ways;
+}
+
+// First invalid way, found by scanning the items
+static uint32_t scanInvalidWay(CheckedSet& set, uint32_t enabled_ways)
+{
+    for(uint32_t w=0; w<enabled_ways; w++)
+    {
+        if(!set.getItemAtWay(w).isValid())
+        {
+            return w;
+        }
+    }
+    return enabled_ways;
+}
+
+static bool check(uint32_t ways, uint32_t disabled_ways, uint32_t seed)
+{
+    sparta::cache::DefaultAddrDecoder decoder(ways*LINE_SIZE, LINE_SIZE, LINE_SIZE, ways, false);
+    CheckedSet set(0, ways, CheckedLine(), &decoder, sparta::cache::TreePLRUReplacement(ways));
+    set.disableWays(disabled_ways);
+    uint32_t enabled_ways=ways-disabled_ways;
+
+    std::mt19937_64 rng(seed);
+    uint64_t hash=14695981039346656037ULL; // FNV-1a
+    uint64_t hits=0;
+    for(uint32_t i=0; i<ACCESSES; i++)
+    {
+        // Twice as many tags as ways, so there are both hits and misses
+        uint64_t tag=rng()%(2*ways);
+        uint32_t way=set.findWay(tag);
+        if(way!=scanWay(set, enabled_ways, tag) || set.findInvalidWay()!=scanInvalidWay(set, enabled_ways))
+        {
+            printf("MISMATCH ways=%u disabled=%u seed=%u access=%u\n", ways, disabled_ways, seed, i);
+            return false;
+        }
+
+        if(way<enabled_ways)
+        {
+            hits++;
+            set.getReplacementIF()->touchMRU(way);
+        }
+        else
+        {
+            CheckedLine& victim=set.getItemForReplacementWithInvalidCheck();
+            way=victim.getWay();
+            victim.setAddr(tag*LINE_SIZE);
+            victim.setValid(true);
+            set.syncWay(way);
+            set.getReplacementIF()->touchMRU(way);
+        }
+        hash=(hash ^ way)*1099511628211ULL;
+
+        // Invalidate a random way now and then, so the valid bits have holes
+        if(rng()%8==0)
+        {
+            uint32_t invalidated=rng()%enabled_ways;
+            set.getItemAtWay(invalidated).setValid(false);
+            set.syncWay(invalidated);
+        }
+    }
+    printf("ways=%u disabled=%u seed=%u hits=%lu hash=%016lx\n", ways, disabled_ways, seed,
+           static_cast<unsigned long>(hits), static_cast<unsigned long>(hash));
+    return true;
+}
+
+int main()
+{
+#if defined(__AVX2__)
+    fprintf(stderr, "Checking the AVX2 lookups\n");
+#elif defined(__SSE4_1__)
+    fprintf(stderr, "Checking the SSE4.1 lookups\n");
+#else
+    fprintf(stderr, "Checking the scalar lookups\n");
+#endif
+    bool ok=true;
+    for(uint32_t ways : {1, 2, 3, 4, 5, 7, 8, 16, 20, 64, 65, 70, 128})
+    {
+        for(uint32_t disabled_ways : {0u, ways/4, ways/2})
+        {
+            for(uint32_t seed=1; seed<=3; seed++)
+            {
+                ok=check(ways, disabled_ways, seed) && ok;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+
+# Checks that the scalar, SSE4.1 and AVX2 tag lookups of BasicCacheSet find the same hits and victim ways.
+# Each build checks its lookups against a scan of the cache items on random access streams, and their
+# summaries must be identical. Sparta is taken from SPARTA_PATH, as in CMakeLists.txt.
+# The SSE4.1 and AVX2 builds are skipped if the compiler does not support them.
+
+set -e
+set -x
+
+SPARTA_BASE=${SPARTA_PATH:-../map/sparta}
+CXX=${CXX:-g++}
+FLAGS="-std=c++17 -O2 -Wall -Wextra -Werror -I${SPARTA_BASE} -I./src"
+
+$CXX $FLAGS -mno-avx2 -mno-sse4.1 test_cache_set_lookups.cpp -o test_cache_set_lookups_scalar
+./test_cache_set_lookups_scalar > test_cache_set_lookups_scalar.txt
+
+for isa in sse4.1 avx2; do
+    if $CXX $FLAGS -m$isa test_cache_set_lookups.cpp -o test_cache_set_lookups_$isa; then
+        ./test_cache_set_lookups_$isa > test_cache_set_lookups_$isa.txt
+        diff test_cache_set_lookups_scalar.txt test_cache_set_lookups_$isa.txt || exit 1
+    fi
+done
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# 
+# Copyright 2022 Barcelona Supercomputing Center - Centro Nacional de
+#                Supercomputación
+# 
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# 
+#     http://www.apache.org/licenses/LICENSE-2.0
+# 
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+# implied.
+# See the LICENSE file in the root directory of the project for the
+# specific language governing permissions and limitations under the
+# License.
+# 
+
+# Converts the packet count matrix file written by the simple NoC model (<packet_count_file_prefix>matrix.bin)
+# to one set of CSV files per period: the packets by destination (dst_), by source (src_) and from each
+# source to each destination (dst_src_), for each NoC network and aggregated over all of them.
+
+import sys
+import struct
+import argparse
+
+MAGIC = b'COYNOCTM'
+VERSION = 1
+
+
+def read_header(f):
+    if f.read(8) != MAGIC:
+        sys.exit('Not a NoC packet count matrix file')
+    version, x_size, y_size, num_networks, flush = struct.unpack('<IHHHB', f.read(11))
+    if version != VERSION:
+        sys.exit('Unsupported packet count matrix version: ' + str(version))
+    networks = []
+    for _ in range(num_networks):
+        length, = struct.unpack('<H', f.read(2))
+        networks.append(f.read(length).decode())
+    return x_size, y_size, networks
+
+
+def write_matrix(filename, rows):
+    with open(filename, 'w') as out:
+        for row in rows:
+            out.write(''.join(str(value) + ';' for value in row) + '\n')
+
+
+def write_slice(prefix, cycle, x_size, y_size, networks, counts):
+    nodes = x_size * y_size
+    num_networks = len(networks)
+    suffix = '_' + str(cycle) + '.csv'
+
+    # counts is indexed by [dst node][src node][network]
+    dst_src = [[[counts[(dst * nodes + src) * num_networks + n] for src in range(nodes)] for dst in range(nodes)]
+               for n in range(num_networks)]
+    dst = [[sum(row) for row in matrix] for matrix in dst_src]
+    src = [[sum(matrix[d][s] for d in range(nodes)) for s in range(nodes)] for matrix in dst_src]
+
+    def aggregated(per_network):
+        return [sum(values) for values in zip(*per_network)]
+
+    def by_rows(values):
+        return [values[y * x_size:(y + 1) * x_size] for y in range(y_size)]
+
+    for n, network in enumerate(networks):
+        write_matrix(prefix + 'dst_' + network + suffix, by_rows(dst[n]))
+    write_matrix(prefix + 'dst_aggregated' + suffix, by_rows(aggregated(dst)))
+    for n, network in enumerate(networks):
+        write_matrix(prefix + 'src_' + network + suffix, by_rows(src[n]))
+    write_matrix(prefix + 'src_aggregated' + suffix, by_rows(aggregated(src)))
+    for n, network in enumerate(networks):
+        write_matrix(prefix + 'dst_src_' + network + suffix, dst_src[n])
+    write_matrix(prefix + 'dst_src_aggregated' + suffix,
+                 [aggregated([dst_src[n][d] for n in range(num_networks)]) for d in range(nodes)])
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a NoC packet count matrix file to CSV files')
+    parser.add_argument('matrix', help='The packet count matrix file (<packet_count_file_prefix>matrix.bin)')
+    parser.add_argument('-p', '--prefix', help='The prefix of the CSV files (default: the packet_count_file_prefix of the matrix file)')
+    args = parser.parse_args()
+
+    prefix = args.prefix
+    if prefix is None:
+        prefix = args.matrix[:-len('matrix.bin')] if args.matrix.endswith('matrix.bin') else args.matrix + '_'
+
+    with open(args.matrix, 'rb') as f:
+        x_size, y_size, networks = read_header(f)
+        slice_counts = (x_size * y_size) ** 2 * len(networks)
+        slice_format = '<Q' + str(slice_counts) + 'Q'
+        slice_size = struct.calcsize(slice_format)
+        while True:
+            data = f.read(slice_size)
+            if len(data) < slice_size:
+                break
+            values = struct.unpack(slice_format, data)
+            write_slice(prefix, values[0], x_size, y_size, networks, values[1:])
+
+
+if __name__ == '__main__':
+    main()